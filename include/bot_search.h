@@ -0,0 +1,67 @@
+#ifndef BOT_SEARCH_H
+#define BOT_SEARCH_H
+
+#include <stdint.h>
+#include <time.h>
+#include "state.h"
+
+#define SEARCH_DEFAULT_ROUNDS 6     /* rondas completas simuladas por rollout */
+
+/**
+ * @brief Parámetros de la búsqueda del ejecutable 'player3'.
+ */
+typedef struct SearchConfig {
+    unsigned threads;           /**< @brief hilos de búsqueda, incluido el llamador (>= 1) */
+    unsigned max_rollouts;      /**< @brief tope de iteraciones (árbol + rollout) por hilo y jugada (0 = sólo tiempo) */
+    unsigned rollout_rounds;    /**< @brief horizonte: rondas simuladas tras la ronda de la jugada */
+    uint64_t seed;              /**< @brief semilla base de los generadores por hilo */
+} SearchConfig;
+
+/**
+ * @brief Buscador MCTS (UCT) con pool de hilos propio (opaco).
+ *
+ * Cada hilo arma su propio árbol sobre una copia privada del tablero: baja
+ * eligiendo con UCB1 en cada nivel (max^n: cada nodo guarda el valor del
+ * jugador que movió), expande una hoja por iteración, completa el horizonte
+ * con un rollout rápido y propaga el valor hacia la raíz; las jugadas se
+ * aplican con rules_apply y se deshacen con un registro de celdas. Al
+ * terminar se suman las visitas de la raíz de todos los hilos (paralelismo
+ * de raíz).
+ */
+typedef struct SearchBot SearchBot;
+
+/**
+ * @brief Crea el buscador y lanza threads-1 hilos trabajadores.
+ * @param cfg Configuración (se copia).
+ * @return buscador o NULL si falló la memoria o pthread_create.
+ */
+SearchBot *search_create(const SearchConfig *cfg);
+
+/**
+ * @brief Detiene los hilos y libera el buscador.
+ * @param b Buscador (NULL se ignora).
+ */
+void search_destroy(SearchBot *b);
+
+/**
+ * @brief Elige una jugada para el jugador my.
+ * @param b Buscador.
+ * @param G Estado raíz; debe ser una copia privada estable (no la shm), no se modifica.
+ * @param my Índice del jugador que mueve.
+ * @param deadline Instante CLOCK_MONOTONIC en que la búsqueda debe cortar (NULL = sólo max_rollouts).
+ * @param[out] out_dir Recibe la dirección elegida (0..7).
+ * @return 1 si hay al menos un movimiento válido, 0 si el jugador debe pasar.
+ */
+int search_choose(SearchBot *b, const GameState *G, int my, const struct timespec *deadline, uint8_t *out_dir);
+
+/**
+ * @brief Hilos sugeridos para este proceso.
+ *
+ * Reparte las CPUs disponibles (afinidad) entre los jugadores de búsqueda
+ * ('player3'), descontando un núcleo por cada jugador de otro tipo.
+ * @param G Estado del juego (usa n_players y P[].name).
+ * @return cantidad de hilos, al menos 1.
+ */
+unsigned search_suggest_threads(const GameState *G);
+
+#endif // BOT_SEARCH_H
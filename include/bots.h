@@ -0,0 +1,73 @@
+#ifndef BOTS_H
+#define BOTS_H
+
+#include <stdint.h>
+#include "state.h"
+#include "reward_index.h"
+#include "voronoi.h"
+
+/**
+ * @brief Estado que 'player2' conserva entre turnos.
+ */
+typedef struct HeuristicCtx {
+    RewardIndex ri;     /**< @brief índice de recompensas restantes */
+    VoronoiWork vw;     /**< @brief buffers del evaluador de territorio */
+    bool ri_external;   /**< @brief el llamador sincroniza 'ri' bajo lock; elegir sólo lo consulta */
+} HeuristicCtx;
+
+/**
+ * @brief Política del ejecutable 'player': elige la dirección válida de mayor ganancia.
+ * @param G Puntero al estado del juego (lectura, protegido por el llamador).
+ * @param my Índice del jugador que mueve.
+ * @param[out] out_dir Recibe la dirección elegida (0..7).
+ * @return 1 si hay al menos un movimiento válido, 0 si el jugador debe pasar.
+ */
+int bot_greedy_choose(const GameState *G, int my, uint8_t *out_dir);
+
+/**
+ * @brief Inicializa el contexto de player2 (los buffers se reservan al primer uso).
+ * @param ctx Contexto a inicializar.
+ */
+void bot_heuristic_init(HeuristicCtx *ctx);
+
+/**
+ * @brief Libera el contexto de player2.
+ * @param ctx Contexto a liberar.
+ */
+void bot_heuristic_free(HeuristicCtx *ctx);
+
+/**
+ * @brief Política del ejecutable 'player2': combina ganancia, bordes, espacio libre,
+ *        cercanía de rivales, un vector global hacia zonas con recompensa y el
+ *        territorio (Voronoi) que le queda tras cada jugada candidata.
+ * @param G Puntero al estado del juego (lectura, protegido por el llamador).
+ * @param my Índice del jugador que mueve.
+ * @param ctx Estado entre turnos; NULL recorre el tablero completo y omite el territorio.
+ * @param[out] out_dir Recibe la dirección elegida (0..7).
+ * @return 1 si hay al menos un movimiento válido, 0 si el jugador debe pasar.
+ */
+int bot_heuristic_choose(const GameState *G, int my, HeuristicCtx *ctx, uint8_t *out_dir);
+
+/**
+ * @brief Cuenta celdas libres alcanzables desde (nx,ny) dentro de una ventana de radio R.
+ * @param G Puntero al estado del juego.
+ * @param nx Coordenada x inicial.
+ * @param ny Coordenada y inicial.
+ * @param R Radio de la ventana (se recorta a 31: una palabra de 64 bits por fila).
+ * @return cantidad de celdas libres alcanzables (8-conectado), 0 si (nx,ny) no es libre.
+ */
+int bot_free_space_window(const GameState *G, int nx, int ny, int R);
+
+/**
+ * @brief Vector global hacia zonas con recompensa, ponderado por distancia.
+ *
+ * Recorre el tablero entero (O(W*H)); es la referencia exacta de reward_index_vector.
+ * @param G Puntero al estado del juego.
+ * @param x Posición x de referencia.
+ * @param y Posición y de referencia.
+ * @param[out] out_vx Componente x del vector.
+ * @param[out] out_vy Componente y del vector.
+ */
+void bot_reward_vector(const GameState *G, int x, int y, long long *out_vx, long long *out_vy);
+
+#endif // BOTS_H
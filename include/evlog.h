@@ -0,0 +1,116 @@
+#ifndef EVLOG_H
+#define EVLOG_H
+
+#include <stdint.h>
+
+#define EVLOG_MAGIC "CHEVLOG1"      /* cabecera del archivo binario */
+#define EVLOG_VERSION 1
+#define EVLOG_RING_LEN 4096         /* registros en memoria antes de descartar (potencia de 2) */
+#define EVLOG_DRAIN_MS 5            /* período del hilo escritor */
+#define EVLOG_LEVEL_ENV "CHOMP_LOG_LEVEL"
+#define EVLOG_PLAYER_PATH_FMT "./logs/player-%d.evlog"   /* por pid, junto al .log de stderr */
+
+/**
+ * @brief Niveles del filtro: se registran los eventos de nivel <= al configurado.
+ */
+typedef enum {
+    EVLOG_OFF = -1,     /**< sin log (no se crea el archivo ni el hilo) */
+    EVLOG_ERROR = 0,    /**< errores de lectura y fin anómalo */
+    EVLOG_INFO          /**< un registro por jugada en master y players (default) */
+} EvLevel;
+
+/**
+ * @brief Tipos de registro; los argumentos de cada uno se documentan al lado.
+ */
+typedef enum {
+    EV_VALID = 1,       /**< arg: dir | gain << 8, score, x, y */
+    EV_INVALID,         /**< arg: dir, invalids */
+    EV_PASS,            /**< el jugador pasó y queda bloqueado */
+    EV_BLOCKED,         /**< el jugador quedó sin movimientos */
+    EV_TIMEOUT,         /**< venció el timeout individual */
+    EV_EOF,             /**< el jugador cerró su pipe */
+    EV_READ_ERROR,      /**< arg: errno */
+    EV_PLAYER_MOVE,     /**< (player) arg: dir, microsegundos pensando */
+    EV_DROPPED          /**< arg: registros descartados por anillo lleno */
+} EvKind;
+
+/**
+ * @brief Registro binario de tamaño fijo (32 bytes, orden de bytes del host).
+ */
+typedef struct EvRecord {
+    uint64_t t_ns;      /**< CLOCK_MONOTONIC en ns */
+    uint16_t kind;      /**< EvKind */
+    uint8_t level;      /**< EvLevel */
+    uint8_t player;     /**< índice del jugador */
+    uint32_t round;     /**< ronda del master (0 en players) */
+    uint32_t arg[4];    /**< argumentos según kind */
+} EvRecord;
+
+/**
+ * @brief Cabecera del archivo: magic, versión y tamaño de registro.
+ */
+typedef struct EvFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} EvFileHeader;
+
+/**
+ * @brief Abre el log del proceso y lanza el hilo escritor.
+ *
+ * Los registros se encolan en un anillo en memoria sin locks y el hilo los
+ * vuelca en lotes; si el anillo se llena se descartan y se cuentan.
+ * @param path archivo de salida (se trunca).
+ * @param level nivel del filtro (EVLOG_OFF = no abrir nada).
+ * @return 0 si OK o si level es EVLOG_OFF, -1 en error (errno seteado; el log queda apagado).
+ */
+int evlog_open(const char *path, int level);
+
+/**
+ * @brief Vacía lo pendiente, detiene el hilo y cierra el archivo.
+ */
+void evlog_close(void);
+
+/**
+ * @brief Indica si un evento de ese nivel se registraría.
+ * @param level nivel del evento.
+ * @return 1 si pasa el filtro, 0 si no.
+ */
+int evlog_enabled(int level);
+
+/**
+ * @brief Encola un registro (no bloquea ni hace syscalls).
+ * @param level nivel del evento.
+ * @param kind tipo (EvKind).
+ * @param player índice del jugador.
+ * @param round ronda.
+ * @param a0 primer argumento.
+ * @param a1 segundo argumento.
+ * @param a2 tercer argumento.
+ * @param a3 cuarto argumento.
+ */
+void evlog_emit(int level, int kind, unsigned player, unsigned round,
+                uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/**
+ * @brief Reloj de los registros (CLOCK_MONOTONIC en ns).
+ * @return instante actual.
+ */
+uint64_t evlog_clock_ns(void);
+
+/**
+ * @brief Parsea un nivel: 'off', 'error', 'info' o su número.
+ * @param s texto.
+ * @param[out] out nivel.
+ * @return 0 si OK, -1 si no es válido.
+ */
+int evlog_parse_level(const char *s, int *out);
+
+/**
+ * @brief Nivel pedido por el entorno (lo exporta el master a sus hijos).
+ * @param def nivel si la variable no está o no es válida.
+ * @return nivel.
+ */
+int evlog_level_from_env(int def);
+
+#endif // EVLOG_H
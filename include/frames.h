@@ -0,0 +1,93 @@
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "state.h"
+
+#define SHM_GAME_FRAMES "/game_frames"
+#define FRAME_SLOTS 3               /* triple buffer: master escribe, view lee, uno listo */
+#define FRAME_FRESH 0x4u            /* bit de 'ready': el slot listo todavía no lo tomó la view */
+#define FRAME_SLOT_HDR 64           /* bytes antes del GameState de cada slot */
+#define FRAMES_DEFAULT_FPS 30
+
+/**
+ * @brief Cabecera del segmento de frames; le siguen FRAME_SLOTS slots de slot_bytes.
+ *
+ * Cada slot es un uint64_t con el número de publicación seguido (en
+ * FRAME_SLOT_HDR) de una copia completa del GameState.
+ */
+typedef struct FrameHeader {
+    _Alignas(64) atomic_uint ready; /**< slot listo para la view | FRAME_FRESH si es nuevo */
+    unsigned w, h, cell_format;     /**< dimensiones de los snapshots */
+    unsigned fps;                   /**< tope de frames por segundo de la view */
+    uint64_t slot_bytes;            /**< distancia entre slots (múltiplo de 64) */
+} FrameHeader;
+
+typedef struct FrameWriter FrameWriter;
+typedef struct FrameReader FrameReader;
+
+/**
+ * @brief Crea el segmento de frames a partir del estado actual (master).
+ * @param G estado compartido (dimensiones y formato).
+ * @param fps tope de publicaciones y de render por segundo (0 = FRAMES_DEFAULT_FPS).
+ * @return writer o NULL en error (errno seteado).
+ */
+FrameWriter *frames_create(const GameState *G, unsigned fps);
+
+/**
+ * @brief Marca una fila del tablero como modificada desde la última publicación.
+ * @param fw writer (NULL se ignora).
+ * @param y fila.
+ */
+void frames_mark_row(FrameWriter *fw, unsigned y);
+
+/**
+ * @brief Publica un snapshot de G si pasó el intervalo del tope de fps (master).
+ *
+ * Copia al slot libre sólo las filas marcadas desde la última vez que ese
+ * slot se escribió, más jugadores y agregados, y lo intercambia con el
+ * listo. Nunca espera a la view ni hace syscalls.
+ * @param fw writer (NULL se ignora).
+ * @param G estado (el master es el único escritor: no hace falta el lock).
+ * @param force publicar aunque no haya pasado el intervalo (frame inicial, game over).
+ * @return 1 si publicó, 0 si no.
+ */
+int frames_publish(FrameWriter *fw, const GameState *G, int force);
+
+/**
+ * @brief Desmapea y elimina el segmento (master).
+ * @param fw writer (NULL se ignora).
+ */
+void frames_destroy(FrameWriter *fw);
+
+/**
+ * @brief Se conecta al segmento de frames (view).
+ * @return reader o NULL en error (errno seteado).
+ */
+FrameReader *frames_attach(void);
+
+/**
+ * @brief Tope de fps fijado por el master.
+ * @param fr reader.
+ * @return frames por segundo.
+ */
+unsigned frames_fps(const FrameReader *fr);
+
+/**
+ * @brief Toma el frame más nuevo si hay uno que la view no vio (view).
+ *
+ * Los frames intermedios que el master publicó entretanto se saltean.
+ * @param fr reader.
+ * @param[out] seq número de publicación del frame (puede ser NULL).
+ * @return estado del frame (válido hasta la próxima llamada) o NULL si no hay nada nuevo.
+ */
+GameState *frames_latest(FrameReader *fr, uint64_t *seq);
+
+/**
+ * @brief Desmapea el segmento (view).
+ * @param fr reader (NULL se ignora).
+ */
+void frames_detach(FrameReader *fr);
+
+#endif // FRAMES_H
@@ -0,0 +1,32 @@
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <stdatomic.h>
+#include <time.h>
+
+/**
+ * @brief Duerme mientras *word valga expected (futex compartido entre procesos).
+ * @param word palabra futex (en memoria compartida).
+ * @param expected valor observado antes de dormir.
+ * @param deadline instante absoluto CLOCK_MONOTONIC, o NULL para esperar indefinidamente.
+ * @return 0 si fue despertado o el valor ya había cambiado,
+ *        -1 en timeout (errno = ETIMEDOUT), señal (EINTR) u otro error.
+ */
+int futex_wait(atomic_uint *word, unsigned expected, const struct timespec *deadline);
+
+/**
+ * @brief Despierta hasta n procesos dormidos en word.
+ * @param word palabra futex.
+ * @param n cantidad máxima de procesos a despertar (INT_MAX = todos).
+ * @return cantidad despertada, -1 en error (errno seteado).
+ */
+int futex_wake(atomic_uint *word, int n);
+
+/**
+ * @brief Calcula un deadline absoluto CLOCK_MONOTONIC a timeout_ms desde ahora.
+ * @param[out] ts deadline resultante.
+ * @param timeout_ms milisegundos a sumar.
+ */
+void futex_deadline_ms(struct timespec *ts, int timeout_ms);
+
+#endif // FUTEX_H
@@ -0,0 +1,147 @@
+#ifndef MASTER_EVENTS_H
+#define MASTER_EVENTS_H
+
+#include <stdint.h>
+#include <signal.h>
+#include <time.h>
+#include "state.h"
+
+#define EVENTS_QUEUE_LEN 16
+#define RING_POLL_MS 20     /* con anillos: cada cuánto se revisan señales, timers y EOF */
+
+/**
+ * @brief Resultado de esperar el movimiento del jugador en turno.
+ */
+typedef enum {
+    EVT_MOVE = 0,           /**< llegó un byte de movimiento */
+    EVT_EOF,                /**< el jugador cerró su pipe */
+    EVT_ERROR,              /**< error de lectura (errno seteado) */
+    EVT_STOP,               /**< SIGINT/SIGTERM recibido por el signalfd */
+    EVT_TURN_TIMEOUT,       /**< venció el timeout individual del jugador */
+    EVT_VALID_TIMEOUT       /**< venció el timeout global entre movimientos válidos */
+} EventKind;
+
+/**
+ * @brief Estado por jugador: bytes ya leídos del pipe y pendientes de consumir.
+ */
+typedef struct {
+    int fd;                          /**< extremo de lectura del pipe (-1 si cerrado) */
+    uint8_t q[EVENTS_QUEUE_LEN];     /**< movimientos leídos por adelantado */
+    unsigned qh, qn;                 /**< cabeza y cantidad en q */
+    int ready;                       /**< epoll avisó datos/EOF sin consumir (edge-triggered) */
+    int hup;                         /**< el escritor cerró: mantener 'ready' hasta leer EOF */
+    int ring;                        /**< los movimientos llegan por el anillo en shm (ver sync.h) */
+} EventsPlayer;
+
+/**
+ * @brief Loop de eventos del master: un único epoll para pipes, señales y timers.
+ */
+typedef struct {
+    int epfd;                        /**< instancia epoll */
+    int sigfd;                       /**< signalfd con SIGINT/SIGTERM */
+    int turn_tfd;                    /**< timerfd del timeout individual */
+    int valid_tfd;                   /**< timerfd del timeout entre válidas */
+    int valid_timeout_ms;            /**< timeout entre válidas (0 = deshabilitado) */
+    struct timespec last_valid;      /**< instante del último movimiento válido */
+    struct timespec turn_deadline;   /**< vencimiento absoluto del turno en curso */
+    int turn_armed;                  /**< hay timeout individual armado */
+    struct timespec ring_polled;     /**< última revisión de fds mientras se atienden anillos */
+    EventsPlayer P[MAX_PLAYERS];     /**< estado por jugador */
+} MasterEvents;
+
+/**
+ * @brief Bloquea SIGINT/SIGTERM y crea epoll, signalfd y timerfds.
+ * @param ev Loop a inicializar.
+ * @param[out] old_mask Recibe la máscara previa (para restaurarla en los hijos).
+ * @return 0 en éxito, -1 en error (errno seteado).
+ */
+int events_init(MasterEvents *ev, sigset_t *old_mask);
+
+/**
+ * @brief Registra el pipe del jugador i (lo pasa a modo no bloqueante).
+ * @param ev Loop de eventos.
+ * @param i índice del jugador.
+ * @param fd extremo de lectura del pipe.
+ * @return 0 en éxito, -1 en error (errno seteado).
+ */
+int events_add_player(MasterEvents *ev, unsigned i, int fd);
+
+/**
+ * @brief Quita del epoll y cierra el pipe del jugador i.
+ * @param ev Loop de eventos.
+ * @param i índice del jugador.
+ */
+void events_close_player(MasterEvents *ev, unsigned i);
+
+/**
+ * @brief Toma los movimientos del jugador i de su anillo en shm en vez del pipe.
+ *
+ * El pipe sigue registrado para EOF; si el jugador igualmente escribe en él,
+ * se vuelve al pipe para ese jugador.
+ * @param ev Loop de eventos.
+ * @param i índice del jugador.
+ */
+void events_use_ring(MasterEvents *ev, unsigned i);
+
+/**
+ * @brief Configura el timeout entre válidas y arranca su reloj ahora.
+ * @param ev Loop de eventos.
+ * @param timeout_ms timeout en ms (0 = deshabilitado).
+ * @return 0 en éxito, -1 en error (errno seteado).
+ */
+int events_set_valid_timeout(MasterEvents *ev, int timeout_ms);
+
+/**
+ * @brief Registra un movimiento válido (reinicia el reloj entre válidas sin syscalls).
+ * @param ev Loop de eventos.
+ */
+void events_mark_valid(MasterEvents *ev);
+
+/**
+ * @brief Milisegundos transcurridos desde el último movimiento válido.
+ * @param ev Loop de eventos.
+ * @return ms desde el último válido.
+ */
+long events_ms_since_valid(const MasterEvents *ev);
+
+/**
+ * @brief Arma el timeout individual del turno que se acaba de otorgar.
+ * @param ev Loop de eventos.
+ * @param timeout_ms timeout en ms (0 = sin timeout individual).
+ * @return 0 en éxito, -1 en error (errno seteado).
+ */
+int events_arm_turn(MasterEvents *ev, int timeout_ms);
+
+/**
+ * @brief Espera el próximo evento relevante para el jugador en turno.
+ *
+ * Los datos que lleguen por pipes de otros jugadores quedan marcados y se
+ * consumen cuando les toque el turno. Con anillo, el master duerme en su
+ * futex y revisa señales, timers y EOF cada RING_POLL_MS.
+ *
+ * @param ev Loop de eventos.
+ * @param i índice del jugador en turno.
+ * @param[out] mv Recibe el byte de movimiento cuando se devuelve EVT_MOVE.
+ * @return tipo de evento (EventKind).
+ */
+EventKind events_wait_player(MasterEvents *ev, unsigned i, uint8_t *mv);
+
+/**
+ * @brief Duerme hasta 'ms' milisegundos atendiendo sólo el signalfd.
+ *
+ * Para las esperas del master fuera de events_wait_player (delay entre
+ * movimientos, handshake con la view, recolección de hijos): SIGINT/SIGTERM
+ * siguen bloqueadas y únicamente se ven por acá.
+ * @param ev Loop de eventos.
+ * @param ms espera máxima en ms (0 = sólo revisar).
+ * @return 1 si llegó SIGINT/SIGTERM (se consume), 0 si venció el plazo.
+ */
+int events_sleep(MasterEvents *ev, int ms);
+
+/**
+ * @brief Libera epoll, signalfd y timerfds (no cierra pipes ya cerrados).
+ * @param ev Loop de eventos.
+ */
+void events_destroy(MasterEvents *ev);
+
+#endif // MASTER_EVENTS_H
@@ -1,17 +1,26 @@
 #ifndef MASTER_LOGIC_H
 #define MASTER_LOGIC_H
 
+#define MASTER_REPLAY_PATH_FMT "./logs/game.%s.replay"   /* replay por defecto (-R); %s = namespace de las shm */
 
 /**
  * @brief Configuración del master (parámetros de ejecución).
  */
 typedef struct {
-    int width;                  /* ancho del tablero */
-    int height;                 /* alto del tablero */
+    unsigned width;             /* ancho del tablero (10..STATE_MAX_SIDE) */
+    unsigned height;            /* alto del tablero (10..STATE_MAX_SIDE) */
     int delay;                  /* delay de poll en ms (select) */
     int timeout;                /* timeout de ronda en ms (0 = deshabilitado) */
     int player_timeout_ms;      /* NUEVO: timeout individual por jugador en ms (0 = deshabilitado) */
     unsigned int seed;          /* semilla de RNG */
+    int cell_format;            /* CellFormat del tablero (CELL_FMT_INT por defecto) */
+    unsigned shm_flags;         /* opciones de mapeo SHM_MAP_* (0 = mapeo normal) */
+    int move_rings;             /* movimientos por anillos en shm en vez de pipes (-r) */
+    int log_level;              /* nivel del log binario de eventos (EvLevel, -l) */
+    char *replay_path;          /* archivo de replay (-R; NULL = el default del namespace) */
+    int replay_off;             /* -R off: no grabar */
+    int view_fps;               /* >0: view por triple buffer con ese tope de fps (-F); 0 = sincrónica */
+    char *shm_tag;              /* etiqueta del namespace de las shm (-N; NULL = sólo el pid) */
     char *view_path;            /* path al ejecutable view (opcional) */
     char *player_paths[9];      /* paths a ejecutables player */
     int player_count;           /* cantidad de players */
@@ -0,0 +1,144 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include "state.h"
+
+#define REPLAY_MAGIC "CHREPLY1"
+#define REPLAY_VERSION 1
+#define REPLAY_BOARD_GEN 2              /* versión de board_fill_rewards con la que se regenera el tablero */
+#define REPLAY_KEYS_PER_GAME 16         /* keyframes buscados en una partida de largo máximo */
+#define REPLAY_KEY_MIN_INTERVAL 32      /* piso de jugadas entre keyframes */
+
+/**
+ * @brief Resultado de un turno, tal como lo aplica el master.
+ */
+typedef enum {
+    REPLAY_VALID = 0,       /**< rules_apply con la dirección */
+    REPLAY_INVALID,         /**< invalids++ (se guarda el byte recibido) */
+    REPLAY_PASS,            /**< el jugador pasó: queda bloqueado */
+    REPLAY_TIMEOUT          /**< timeouts++ */
+} ReplayOutcome;
+
+/**
+ * @brief Cabecera fija del archivo (orden de bytes del host).
+ *
+ * El tablero inicial no se guarda: se regenera con la semilla y se le
+ * aplican las posiciones iniciales registradas acá.
+ */
+typedef struct ReplayHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t board_gen;                 /**< REPLAY_BOARD_GEN del writer */
+    uint32_t w, h;
+    uint32_t n_players;
+    uint32_t cell_format;
+    uint32_t seed;
+    uint32_t key_interval;
+    uint32_t start_x[MAX_PLAYERS];      /**< posiciones de players_place_grid */
+    uint32_t start_y[MAX_PLAYERS];
+    char names[MAX_PLAYERS][NAME_LEN];
+} ReplayHeader;
+
+typedef struct ReplayWriter ReplayWriter;
+typedef struct ReplayReader ReplayReader;
+
+/**
+ * @brief Jugadas entre keyframes para una partida de este tamaño.
+ *
+ * El largo esperado es max_rounds × jugadores, acotado por las celdas del
+ * tablero (cada jugada válida captura una); se reparte en REPLAY_KEYS_PER_GAME
+ * tramos, con piso REPLAY_KEY_MIN_INTERVAL.
+ * @param G estado ya ubicado (dimensiones y jugadores).
+ * @param max_rounds límite de rondas de la partida.
+ * @return intervalo para replay_create.
+ */
+unsigned replay_key_interval(const GameState *G, unsigned max_rounds);
+
+/**
+ * @brief Crea el archivo de replay a partir del estado ya ubicado (jugada 0).
+ * @param path archivo de salida (se trunca).
+ * @param G estado tras board_fill_rewards y players_place_grid.
+ * @param seed semilla usada en board_fill_rewards.
+ * @param key_interval jugadas mínimas entre keyframes (0 = REPLAY_KEY_MIN_INTERVAL).
+ * @return writer o NULL en error (errno seteado).
+ */
+ReplayWriter *replay_create(const char *path, const GameState *G, unsigned seed, unsigned key_interval);
+
+/**
+ * @brief Registra un turno; cada tanto agrega un keyframe con el estado G.
+ *
+ * Llamar después de aplicar el turno en G (con el lock de escritura tomado).
+ * Las jugadas válidas ocupan un byte; cada key_interval jugadas se agrega un
+ * keyframe, así un seek reproduce a lo sumo key_interval jugadas.
+ * @param rw writer (NULL se ignora).
+ * @param G estado ya actualizado.
+ * @param player índice del jugador.
+ * @param outcome resultado del turno.
+ * @param mv byte recibido (dirección en REPLAY_VALID).
+ */
+void replay_record(ReplayWriter *rw, const GameState *G, unsigned player, ReplayOutcome outcome, uint8_t mv);
+
+/**
+ * @brief Cierra el stream y escribe el índice de keyframes al final.
+ * @param rw writer (NULL se ignora).
+ * @return 0 si OK, -1 si alguna escritura falló.
+ */
+int replay_close(ReplayWriter *rw);
+
+/**
+ * @brief Abre un replay; usa el índice final o, si falta (partida cortada), recorre el archivo.
+ * @param path archivo.
+ * @return reader o NULL en error (mensaje en stderr).
+ */
+ReplayReader *replay_open(const char *path);
+
+/**
+ * @brief Libera el reader.
+ * @param r reader (NULL se ignora).
+ */
+void replay_free(ReplayReader *r);
+
+/**
+ * @brief Cabecera del replay abierto.
+ * @param r reader.
+ * @return cabecera.
+ */
+const ReplayHeader *replay_header(const ReplayReader *r);
+
+/**
+ * @brief Cantidad total de jugadas registradas.
+ * @param r reader.
+ * @return jugadas.
+ */
+uint64_t replay_moves(const ReplayReader *r);
+
+/**
+ * @brief Cantidad de keyframes en el índice.
+ * @param r reader.
+ * @return keyframes.
+ */
+unsigned replay_keyframes(const ReplayReader *r);
+
+/**
+ * @brief Jugada del keyframe k del índice.
+ * @param r reader.
+ * @param k índice (0..replay_keyframes-1).
+ * @return jugada tras la cual se tomó.
+ */
+uint64_t replay_keyframe_move(const ReplayReader *r, unsigned k);
+
+/**
+ * @brief Reconstruye el estado tras 'move' jugadas.
+ *
+ * Busca en el índice el último keyframe anterior (búsqueda binaria), lo
+ * restaura y aplica sólo las jugadas que faltan.
+ * @param r reader.
+ * @param move jugada destino (se recorta al total).
+ * @param use_keyframes 0 = reproducir desde el inicio (para verificar).
+ * @param[out] G estado de dimensiones w×h y formato de la cabecera (state_alloc).
+ * @return jugada alcanzada, o -1 si el archivo está dañado.
+ */
+int64_t replay_seek(ReplayReader *r, uint64_t move, int use_keyframes, GameState *G);
+
+#endif // REPLAY_H
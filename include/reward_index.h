@@ -0,0 +1,83 @@
+#ifndef REWARD_INDEX_H
+#define REWARD_INDEX_H
+
+#include <stdint.h>
+#include "state.h"
+
+#define RI_BLOCK_SHIFT 3                    /* bloques base de 8x8 celdas */
+#define RI_BLOCK       (1 << RI_BLOCK_SHIFT)
+#define RI_MAX_LEVELS  32
+
+/**
+ * @brief Pirámide de recompensas restantes (quadtree implícito sobre bloques de 8x8).
+ *
+ * Cada nodo guarda la suma de recompensas libres de su bloque; la raíz es
+ * stats.reward_sum.
+ *
+ * Se mantiene entre turnos: las capturas desde la última consulta se deducen de
+ * los deltas de valids/score de cada jugador (cada movimiento válido captura la
+ * celda donde queda el jugador). Ante cualquier inconsistencia se reconstruye.
+ */
+typedef struct RewardIndex {
+    unsigned w, h;                          /**< @brief dimensiones indexadas (0 = sin construir) */
+    unsigned n_players;
+    unsigned levels;                        /**< @brief niveles; el último es la raíz 1x1 */
+    unsigned lw[RI_MAX_LEVELS], lh[RI_MAX_LEVELS];
+    uint64_t *lvl[RI_MAX_LEVELS];           /**< @brief masa por nodo y nivel (un único bloque de memoria) */
+    unsigned seen_valids[MAX_PLAYERS];      /**< @brief valids vistos en la última sincronización */
+    unsigned seen_score[MAX_PLAYERS];       /**< @brief score visto en la última sincronización */
+    unsigned rebuilds;                      /**< @brief reconstrucciones completas realizadas */
+} RewardIndex;
+
+/**
+ * @brief Inicializa un índice vacío (se construye en la primera sincronización).
+ * @param ri Índice a inicializar.
+ */
+void reward_index_init(RewardIndex *ri);
+
+/**
+ * @brief Libera la memoria del índice y lo deja vacío.
+ * @param ri Índice a liberar.
+ */
+void reward_index_free(RewardIndex *ri);
+
+/**
+ * @brief Pone el índice al día con el tablero.
+ *
+ * Aplica en O(niveles) las capturas hechas desde la última llamada y verifica
+ * la masa total contra stats.reward_sum; si no coincide (otra partida, turnos
+ * salteados, lectura rota) reconstruye en O(W*H).
+ * @param ri Índice a sincronizar.
+ * @param G Estado del juego (lectura, protegido por el llamador).
+ * @return 0 si el índice quedó consistente, -1 si no hubo memoria.
+ */
+int reward_index_sync(RewardIndex *ri, const GameState *G);
+
+/**
+ * @brief Indica si el índice ya está al día con el tablero, sin modificarlo.
+ *
+ * Apta para lecturas optimistas: una lectura rota sólo puede dar un falso
+ * negativo, nunca alterar el índice.
+ * @param ri Índice a consultar.
+ * @param G Estado del juego.
+ * @return true si no hay capturas pendientes y la masa total coincide.
+ */
+bool reward_index_current(const RewardIndex *ri, const GameState *G);
+
+/**
+ * @brief Vector global hacia zonas con recompensa; mismo resultado que bot_reward_vector.
+ *
+ * El peso entero (r*10)/(1+dist) se anula a distancia >= 10*r, así que sólo
+ * se desciende por nodos con masa y al alcance; el costo depende de las
+ * recompensas cercanas y no del tamaño del tablero.
+ * @param ri Índice sincronizado con G.
+ * @param G Estado del juego.
+ * @param x Posición x de referencia.
+ * @param y Posición y de referencia.
+ * @param[out] out_vx Componente x del vector.
+ * @param[out] out_vy Componente y del vector.
+ */
+void reward_index_vector(const RewardIndex *ri, const GameState *G, int x, int y,
+                         long long *out_vx, long long *out_vy);
+
+#endif // REWARD_INDEX_H
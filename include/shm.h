@@ -2,8 +2,89 @@
 #define SHM_HELPERS_H
 #include <stddef.h>
 
+/* Opciones de mapeo (combinables), aplicadas a todos los segmentos del proceso */
+#define SHM_MAP_POPULATE 0x1u   /* MAP_POPULATE: prefault completo al mapear */
+#define SHM_MAP_THP      0x2u   /* madvise(MADV_HUGEPAGE) sobre el mapeo */
+#define SHM_MAP_HUGETLB  0x4u   /* respaldo memfd hugetlb; cae a shm_open si no hay páginas */
+
+#define SHM_NS_MAX 48            /* largo máximo del namespace (con el \0) */
+
+/**
+ * @brief Fija el namespace de los segmentos de este proceso y lo exporta a los hijos.
+ *
+ * Con namespace, cada nombre "/game_x" se usa como "/game_x.<ns>", así varias
+ * partidas conviven en el mismo host. Se publica en CHOMP_SHM_NS, de donde lo
+ * toman players, vista y herramientas. Termina en ".<pid del master>" para
+ * que shm_gc_stale sepa si su dueño sigue vivo.
+ * @param ns letras, dígitos, '-', '_' o '.' (NULL o "" = nombres sin namespace).
+ * @return 0 si OK, -1 si el nombre no es válido (errno = EINVAL).
+ */
+int shm_set_namespace(const char *ns);
+
+/**
+ * @brief Namespace vigente (por defecto, el heredado de CHOMP_SHM_NS).
+ * @return namespace o "" si no hay.
+ */
+const char *shm_get_namespace(void);
+
+/**
+ * @brief Elimina los segmentos de namespaces cuyo master ya no existe.
+ *
+ * Recorre /dev/shm buscando nombres que empiecen con prefix y terminen en
+ * ".<pid>"; si ese pid ya terminó (no existe o es zombie) hace shm_unlink. Cubre al
+ * master muerto con SIGKILL, que no llega a limpiar.
+ * @param prefix prefijo de las entradas de /dev/shm (ej. "game_").
+ * @return cantidad eliminada o -1 si no se pudo leer /dev/shm.
+ */
+int shm_gc_stale(const char *prefix);
+
+/**
+ * @brief Namespaces en los que existe el segmento name (herramientas que se conectan desde afuera).
+ * @param name nombre base (ej. "/game_stats").
+ * @param[out] out hasta max namespaces.
+ * @param max capacidad de out.
+ * @return cantidad encontrada (puede ser mayor que max) o -1 si no se pudo leer /dev/shm.
+ */
+int shm_list_namespaces(const char *name, char out[][SHM_NS_MAX], int max);
+
+/**
+ * @brief Elimina los nombres que este proceso creó y todavía no eliminó.
+ *
+ * Sólo hace shm_unlink: se puede registrar con atexit y llamar desde el
+ * handler de una señal fatal.
+ */
+void shm_remove_owned(void);
+
+/**
+ * @brief Fija las opciones de mapeo de este proceso y las exporta a los hijos.
+ *
+ * Se publican en la variable de entorno CHOMP_SHM_MAP, así players y vista
+ * mapean con las mismas opciones que eligió el master.
+ * @param flags Combinación de SHM_MAP_*.
+ */
+void shm_set_map_flags(unsigned flags);
+
+/**
+ * @brief Opciones de mapeo vigentes (por defecto, las heredadas de CHOMP_SHM_MAP).
+ * @return Combinación de SHM_MAP_*.
+ */
+unsigned shm_get_map_flags(void);
+
 /**
- * @brief Crea (o trunca) y mapea un objeto de memoria compartida.
+ * @brief Parsea una lista "populate,thp,hugetlb" (o "none", o el valor numérico).
+ * @param s Texto a parsear.
+ * @param out Recibe las flags en éxito.
+ * @return 0 si OK, -1 si hay una opción desconocida.
+ */
+int shm_parse_map_flags(const char *s, unsigned *out);
+
+/**
+ * @brief Crea (o trunca) y mapea un objeto de memoria compartida (nombre dentro del namespace).
+ *
+ * El respaldo se reserva completo antes de mapear (posix_fallocate), así un
+ * tamaño que no entra en /dev/shm falla acá y no con SIGBUS más adelante.
+ * Con SHM_MAP_HUGETLB el objeto es un memfd (tamaño redondeado a la página
+ * huge) que los demás procesos abren vía /proc/<pid>/fd del creador.
  * @param name Nombre del objeto POSIX shm (ej. "/game_state").
  * @param size Tamaño en bytes a reservar/mmapear.
  * @param prot Flags de protección (p.ej. PROT_READ|PROT_WRITE).
@@ -12,7 +93,7 @@
 void* shm_create_map(const char *name, size_t size, int prot);
 
 /**
- * @brief Abre y mapea un objeto de memoria compartida existente.
+ * @brief Abre y mapea un objeto de memoria compartida existente (nombre dentro del namespace).
  * @param name Nombre del objeto POSIX shm.
  * @param out_size Si no es NULL, recibe el tamaño del objeto mapeado.
  * @param prot Flags de protección usadas en mmap (p.ej. PROT_READ).
@@ -21,7 +102,20 @@ void* shm_create_map(const char *name, size_t size, int prot);
 void* shm_attach_map(const char *name, size_t *out_size, int prot);
 
 /**
- * @brief Elimina el nombre del objeto de memoria compartida (shm_unlink).
+ * @brief Desmapea un segmento obtenido con shm_create_map/shm_attach_map.
+ *
+ * Usa el largo real del mapeo (redondeado en hugetlb); size sólo se usa si
+ * el puntero no fue mapeado por este módulo.
+ * @param p Dirección devuelta por create/attach.
+ * @param size Tamaño lógico del segmento.
+ * @return 0 en éxito, -1 en error (errno seteado).
+ */
+int shm_unmap(void *p, size_t size);
+
+/**
+ * @brief Elimina el nombre del objeto de memoria compartida (shm_unlink, dentro del namespace).
+ *
+ * Si el segmento es un memfd de este proceso, cierra el fd en su lugar.
  * @param name Nombre del objeto POSIX shm a eliminar.
  * @return 0 en éxito, -1 en error (errno seteado).
  */
@@ -0,0 +1,72 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include "state.h"
+#include "replay.h"
+
+#define SIM_MAX_ROUNDS 200
+
+/**
+ * @brief Política de un bot dentro del simulador (llamada directa, sin procesos).
+ * @param G Estado del juego (solo lectura).
+ * @param my Índice del jugador que mueve.
+ * @param ctx Contexto opaco de la política (puede ser NULL).
+ * @param[out] out_dir Dirección elegida.
+ * @return 1 si eligió un movimiento, 0 si pasa (sin movimientos legales).
+ */
+typedef int (*SimPolicyFn)(const GameState *G, int my, void *ctx, uint8_t *out_dir);
+
+/**
+ * @brief Política asignada a un jugador de la simulación.
+ */
+typedef struct {
+    SimPolicyFn choose;     /**< función de decisión */
+    void *ctx;              /**< contexto propio de la política */
+} SimPolicy;
+
+/**
+ * @brief Partida headless: el GameState vive en memoria privada del proceso.
+ */
+typedef struct {
+    GameState *G;           /**< estado (state_alloc, no shm) */
+    unsigned w, h;          /**< dimensiones del tablero */
+    unsigned n_players;     /**< cantidad de jugadores */
+    unsigned max_rounds;    /**< límite de rondas (default SIM_MAX_ROUNDS) */
+    unsigned rounds;        /**< rondas jugadas en la última partida */
+    ReplayWriter *replay;   /**< grabación de la partida en curso (NULL = no graba) */
+} SimGame;
+
+/**
+ * @brief Reserva el estado de una partida headless.
+ * @param s Partida a inicializar.
+ * @param w ancho del tablero.
+ * @param h alto del tablero.
+ * @param n_players número de jugadores (1..MAX_PLAYERS).
+ * @param fmt formato de celdas del tablero.
+ * @return 0 en éxito, -1 en error (errno seteado).
+ */
+int sim_init(SimGame *s, unsigned w, unsigned h, unsigned n_players, CellFormat fmt);
+
+/**
+ * @brief Prepara el tablero inicial igual que el master (zero, rewards, grilla).
+ * @param s Partida inicializada con sim_init.
+ * @param seed semilla del tablero.
+ */
+void sim_reset(SimGame *s, unsigned seed);
+
+/**
+ * @brief Juega una partida completa con las mismas reglas de turnos que el master.
+ * @param s Partida preparada con sim_reset.
+ * @param policies Arreglo de n_players políticas (una por jugador).
+ * @return cantidad de rondas jugadas.
+ */
+unsigned sim_run(SimGame *s, const SimPolicy *policies);
+
+/**
+ * @brief Libera el estado de la partida.
+ * @param s Partida a liberar.
+ */
+void sim_free(SimGame *s);
+
+#endif // SIM_H
@@ -11,6 +11,7 @@
 
 #define MAX_PLAYERS 9
 #define NAME_LEN    16
+#define STATE_MAX_SIDE (1u << 30)   /* lado máximo: x±1 y sumas de coordenadas caben en int */
 #define SHM_GAME_STATE "/game_state"
 
 /**
@@ -27,6 +28,17 @@ typedef enum {
     DIR_NW = 7
 } Dir;
 
+/**
+ * @brief Formato de almacenamiento de las celdas del tablero.
+ *
+ * Ambos usan la misma codificación (recompensa 0..9, capturada = -(owner+1)),
+ * solo cambia el ancho de cada celda.
+ */
+typedef enum {
+    CELL_FMT_INT  = 0,   /**< un int por celda (formato original) */
+    CELL_FMT_BYTE = 1    /**< un int8_t por celda (4x más chico) */
+} CellFormat;
+
 /**
  * @brief Información por jugador almacenada en el estado compartido.
  */
@@ -36,29 +48,65 @@ typedef struct Player {
     unsigned invalids;     /**< @brief Movimientos inválidos realizados */
     unsigned valids;       /**< @brief Movimientos válidos realizados */
     unsigned timeouts;     /**< @brief Turnos vencidos por timeout */
-    unsigned short x, y;   /**< @brief Posición actual del jugador en el tablero */
+    unsigned x, y;         /**< @brief Posición actual del jugador en el tablero */
     pid_t pid;             /**< @brief PID del proceso jugador (0 si no asignado) */
     bool blocked;          /**< @brief Marca si el jugador está bloqueado (sin movimientos legales) */
 } Player;
 
+/**
+ * @brief Agregados del tablero mantenidos en O(1) por captura (sin recorrer el tablero).
+ */
+typedef struct GameStats {
+    uint64_t free_cells;              /**< @brief celdas sin capturar */
+    uint64_t reward_cells;            /**< @brief celdas libres con recompensa > 0 */
+    uint64_t reward_sum;              /**< @brief suma de recompensas aún libres */
+    uint64_t captured[MAX_PLAYERS];   /**< @brief celdas capturadas por cada jugador */
+} GameStats;
+
 /**
  * @brief Representación del estado completo del juego en memoria compartida.
  */
 typedef struct GameState {
-    unsigned short w, h;      /**< @brief ancho y alto del tablero */
+    unsigned w, h;            /**< @brief ancho y alto del tablero */
     unsigned n_players;       /**< @brief número de players válidos en P[] */
     Player P[MAX_PLAYERS];    /**< @brief array de jugadores */
     bool game_over;           /**< @brief flag de fin de partida */
-    int board[];              /**< @brief tablero (arreglo flexible) */
+    unsigned cell_format;     /**< @brief CellFormat de board, fijado al crear el estado */
+    GameStats stats;          /**< @brief agregados del tablero (actualizados por placement y rules_apply) */
+    int board[];              /**< @brief tablero (arreglo flexible, leer con cell_get); le sigue el plano de ocupación */
 } GameState;
 
 /**
  * @brief Crea y mapea un nuevo GameState en memoria compartida.
  * @param w ancho del tablero.
  * @param h alto del tablero.
+ * @param fmt formato de celdas (queda registrado en el header).
  * @return puntero al GameState mapeado o NULL en error.
  */
-GameState* state_create(unsigned w, unsigned h);
+GameState* state_create(unsigned w, unsigned h, CellFormat fmt);
+
+/**
+ * @brief Reserva un GameState en memoria privada del proceso (simulación, copias).
+ * @param w ancho del tablero.
+ * @param h alto del tablero.
+ * @param fmt formato de celdas.
+ * @return puntero al GameState (liberar con free) o NULL en error.
+ */
+GameState* state_alloc(unsigned w, unsigned h, CellFormat fmt);
+
+/**
+ * @brief Pone al día una copia privada con las jugadas hechas en src desde la anterior.
+ *
+ * Cada jugada válida captura la celda donde queda el jugador: si el valids de
+ * cada jugador avanzó a lo sumo en uno y los agregados cuadran, copia sólo esas
+ * celdas y el header (O(jugadores)); si no (primera vez, turnos salteados, otra
+ * partida) copia el estado entero.
+ * @param dst copia privada de las mismas dimensiones y formato (state_alloc).
+ * @param src estado de origen (lectura, protegido por el llamador).
+ * @return 0 si alcanzó con las celdas nuevas, 1 si hizo la copia completa,
+ *         -1 si las dimensiones o el formato no coinciden (errno = EINVAL).
+ */
+int state_sync_copy(GameState *dst, const GameState *src);
 
 /**
  * @brief Se conecta a un GameState existente en memoria compartida.
@@ -73,7 +121,7 @@ GameState* state_attach(void);
 void state_destroy(GameState *g);
 
 /**
- * @brief Inicializa (pone a cero) un GameState recién creado.
+ * @brief Inicializa (pone a cero) un GameState recién creado (conserva cell_format).
  * @param g puntero al GameState.
  * @param w ancho.
  * @param h alto.
@@ -85,34 +133,235 @@ void state_zero(GameState* g, unsigned w, unsigned h, unsigned n);
  * @brief Calcula el tamaño en bytes necesario para un GameState con w×h.
  * @param w ancho.
  * @param h alto.
+ * @param fmt formato de celdas.
  * @return tamaño en bytes.
  */
-size_t state_size(unsigned w, unsigned h);
+size_t state_size(unsigned w, unsigned h, CellFormat fmt);
+
+/**
+ * @brief Como state_size, pero valida lados y overflow antes de reservar nada.
+ *
+ * En 64 bits todo tablero con lados <= STATE_MAX_SIDE entra en PTRDIFF_MAX
+ * (verificado en compilación); en 32 bits el límite lo pone el tamaño.
+ * @param w ancho (1..STATE_MAX_SIDE).
+ * @param h alto (1..STATE_MAX_SIDE).
+ * @param fmt formato de celdas.
+ * @param[out] out_size Recibe el tamaño en bytes si es representable.
+ * @return 0 si el tamaño es válido, -1 si no (errno = EINVAL u EOVERFLOW).
+ */
+int state_size_checked(unsigned w, unsigned h, CellFormat fmt, size_t *out_size);
 
 /**
  * @brief Índice lineal de la celda (x,y) en el arreglo board.
  * @param g puntero al GameState.
  * @param x coordenada x.
  * @param y coordenada y.
- * @return índice en board (0..w*h-1).
+ * @return índice en board (0..w*h-1), calculado en size_t.
  */
-int idx(const GameState *g, unsigned x, unsigned y);
+size_t idx(const GameState *g, unsigned x, unsigned y);
 
 /**
  * @brief Rellena el tablero con recompensas usando una semilla.
+ *
+ * Generador por contador (splitmix64 sobre semilla y número de celda): el
+ * tablero es el mismo en cualquier plataforma y con cualquier cantidad de
+ * hilos. Los tableros grandes se llenan con un hilo por CPU (CHOMP_FILL_THREADS
+ * fuerza la cantidad).
  * @param g puntero al GameState (se modifica).
  * @param seed semilla para el generador.
  */
 void board_fill_rewards(GameState *g, unsigned seed);
 
 /**
- * @brief Coloca jugadores en una disposición inicial (ej. en cuadrícula).
+ * @brief Igual que board_fill_rewards con una cantidad de hilos fija.
+ * @param g puntero al GameState (se modifica).
+ * @param seed semilla para el generador.
+ * @param threads hilos a usar (0 o 1 = sólo el actual).
+ */
+void board_fill_rewards_threads(GameState *g, unsigned seed, unsigned threads);
+
+/**
+ * @brief Coloca jugadores en una disposición inicial (lattice de placement_lattice).
+ *
+ * Si la celda del lattice está ocupada, el jugador va a la libre más cercana
+ * (placement_nearest_free).
  * @param g puntero al GameState (se modifica).
  */
 void players_place_grid(GameState *g);
 
+/**
+ * @brief Posiciones iniciales para n jugadores repartidos en un lattice del tablero.
+ *
+ * Usa cols x filas celdas con la proporción del tablero (cols*cols*h >= n*w) y
+ * pone a cada jugador en el centro de la suya; la última fila, si está
+ * incompleta, se reparte en todo el ancho. Con 9 jugadores en un tablero
+ * cuadrado es la grilla 3x3 de siempre. O(1) por jugador (más O(sqrt(n)) para
+ * elegir el lattice); las posiciones son distintas mientras cols <= w y filas <= h.
+ * @param w ancho del tablero.
+ * @param h alto del tablero.
+ * @param n cantidad de jugadores (sin tope: sirve también para más de MAX_PLAYERS).
+ * @param[out] xs columnas (n elementos).
+ * @param[out] ys filas (n elementos).
+ */
+void placement_lattice(unsigned w, unsigned h, unsigned n, unsigned *xs, unsigned *ys);
+
+/**
+ * @brief Celda libre más cercana (distancia de Chebyshev) a (x0, y0).
+ *
+ * Recorre sólo el anillo de cada radio, en orden de filas: O(r) por radio en
+ * lugar de volver a mirar el cuadrado entero.
+ * @param g estado (se consulta el plano de ocupación).
+ * @param x0 columna de partida.
+ * @param y0 fila de partida.
+ * @param[out] out_x columna encontrada.
+ * @param[out] out_y fila encontrada.
+ * @return 0 si la encontró, -1 si el tablero está lleno.
+ */
+int placement_nearest_free(const GameState *g, unsigned x0, unsigned y0, unsigned *out_x, unsigned *out_y);
+
 /* Helpers inline */
 
+/**
+ * @brief Bytes por celda según el formato.
+ * @param fmt formato de celdas.
+ * @return 1 para CELL_FMT_BYTE, sizeof(int) para CELL_FMT_INT.
+ */
+static inline size_t cell_bytes(unsigned fmt) { return fmt == CELL_FMT_BYTE ? 1 : sizeof(int); }
+
+/**
+ * @brief Lee el valor codificado de la celda i (cualquier formato).
+ * @param g puntero al GameState.
+ * @param i índice lineal (ver idx).
+ * @return valor de la celda (recompensa >= 0 o capturada < 0).
+ */
+static inline int cell_get(const GameState *g, size_t i)
+{
+    if (g->cell_format == CELL_FMT_BYTE)
+        return ((const int8_t *)(const void *)g->board)[i];
+    return g->board[i];
+}
+
+/**
+ * @brief Escribe el valor codificado de la celda i (cualquier formato).
+ * @param g puntero al GameState.
+ * @param i índice lineal (ver idx).
+ * @param v valor (recompensa 0..9 o make_captured()).
+ */
+static inline void cell_set(GameState *g, size_t i, int v)
+{
+    if (g->cell_format == CELL_FMT_BYTE)
+        ((int8_t *)(void *)g->board)[i] = (int8_t)v;
+    else
+        g->board[i] = v;
+}
+
+/**
+ * @brief Actualiza los agregados cuando owner_i captura una celda libre.
+ * @param g puntero al GameState (se modifica).
+ * @param owner_i índice del jugador que captura.
+ * @param reward recompensa que tenía la celda (0 si ninguna).
+ */
+static inline void stats_on_capture(GameState *g, int owner_i, int reward)
+{
+    g->stats.free_cells--;
+    if (reward > 0)
+    {
+        g->stats.reward_cells--;
+        g->stats.reward_sum -= (uint64_t)reward;
+    }
+    g->stats.captured[owner_i]++;
+}
+
+/* --- Plano de ocupación: 1 bit por celda (1 = capturada), filas de palabras de 64 bits --- */
+
+#define OCC_WORD_BITS 64
+
+/**
+ * @brief Palabras de 64 bits por fila del plano de ocupación.
+ * @param w ancho del tablero.
+ * @return cantidad de palabras por fila.
+ */
+static inline size_t occ_words_per_row(unsigned w) { return ((size_t)w + OCC_WORD_BITS - 1) / OCC_WORD_BITS; }
+
+/**
+ * @brief Bytes del tablero, redondeados para que el plano quede alineado a 8.
+ * @param w ancho.
+ * @param h alto.
+ * @param fmt formato de celdas.
+ * @return offset en bytes desde board hasta el plano de ocupación.
+ */
+static inline size_t occ_offset(unsigned w, unsigned h, unsigned fmt)
+{
+    size_t bytes = (size_t)w * (size_t)h * cell_bytes(fmt);
+    return (bytes + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+}
+
+/**
+ * @brief Bytes del plano de ocupación para w×h.
+ * @param w ancho.
+ * @param h alto.
+ * @return tamaño en bytes.
+ */
+static inline size_t occ_bytes(unsigned w, unsigned h) { return occ_words_per_row(w) * (size_t)h * sizeof(uint64_t); }
+
+/**
+ * @brief Fila y del plano de ocupación (lectura).
+ * @param g puntero al GameState.
+ * @param y fila.
+ * @return puntero a la primera palabra de la fila.
+ */
+static inline const uint64_t *occ_row(const GameState *g, unsigned y)
+{
+    const uint64_t *plane = (const uint64_t *)(const void *)((const char *)g->board + occ_offset(g->w, g->h, g->cell_format));
+    return plane + (size_t)y * occ_words_per_row(g->w);
+}
+
+/**
+ * @brief Fila y del plano de ocupación (escritura).
+ * @param g puntero al GameState.
+ * @param y fila.
+ * @return puntero a la primera palabra de la fila.
+ */
+static inline uint64_t *occ_row_mut(GameState *g, unsigned y)
+{
+    uint64_t *plane = (uint64_t *)(void *)((char *)g->board + occ_offset(g->w, g->h, g->cell_format));
+    return plane + (size_t)y * occ_words_per_row(g->w);
+}
+
+/**
+ * @brief Indica si la celda (x,y) está capturada según el plano de ocupación.
+ * @param g puntero al GameState.
+ * @param x coordenada x (dentro del tablero).
+ * @param y coordenada y (dentro del tablero).
+ * @return 1 si está capturada, 0 si está libre.
+ */
+static inline int occ_test(const GameState *g, unsigned x, unsigned y)
+{
+    return (int)((occ_row(g, y)[x / OCC_WORD_BITS] >> (x % OCC_WORD_BITS)) & 1u);
+}
+
+/**
+ * @brief Marca la celda (x,y) como capturada en el plano de ocupación.
+ * @param g puntero al GameState.
+ * @param x coordenada x (dentro del tablero).
+ * @param y coordenada y (dentro del tablero).
+ */
+static inline void occ_set(GameState *g, unsigned x, unsigned y)
+{
+    occ_row_mut(g, y)[x / OCC_WORD_BITS] |= (uint64_t)1 << (x % OCC_WORD_BITS);
+}
+
+/**
+ * @brief Libera la celda (x,y) en el plano de ocupación (deshacer en copias privadas).
+ * @param g puntero al GameState.
+ * @param x coordenada x (dentro del tablero).
+ * @param y coordenada y (dentro del tablero).
+ */
+static inline void occ_clear(GameState *g, unsigned x, unsigned y)
+{
+    occ_row_mut(g, y)[x / OCC_WORD_BITS] &= ~((uint64_t)1 << (x % OCC_WORD_BITS));
+}
+
 /**
  * @brief Obtiene la recompensa (>=0) según el valor almacenado en la celda.
  * @param v valor almacenado en board.
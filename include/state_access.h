@@ -21,6 +21,23 @@ static inline void state_read_begin(void)  { rdlock(); }
  */
 static inline void state_read_end(void)    { rdunlock(); }
 
+/**
+ * @brief Inicia una lectura optimista del GameState (sin locks, sin escribir en shm).
+ *
+ * Uso: do { seq = state_read_optimistic_begin(); ...leer...; } while (state_read_optimistic_retry(seq));
+ * Lo leído solo es válido si state_read_optimistic_retry() devuelve false.
+ *
+ * @return número de secuencia a pasar a state_read_optimistic_retry().
+ */
+static inline unsigned state_read_optimistic_begin(void) { return seq_read_begin(); }
+
+/**
+ * @brief Indica si una lectura optimista se superpuso con una escritura del master.
+ * @param seq valor devuelto por state_read_optimistic_begin().
+ * @return true si hay que repetir la lectura, false si es consistente.
+ */
+static inline bool state_read_optimistic_retry(unsigned seq) { return seq_read_retry(seq) != 0; }
+
 /**
  * @brief Inicia una sección de escritura exclusiva sobre el GameState.
  *
@@ -68,8 +85,30 @@ bool state_is_over(const GameState *G);
 /**
  * @brief Cuenta las recompensas remanentes (valores positivos) en el tablero.
  * @param G Puntero al GameState (debe estar mapeado y protegido por read lock).
- * @return número de celdas con recompensa > 0.
+ * @return número de celdas con recompensa > 0 (O(1), desde G->stats).
+ */
+uint64_t state_remaining_rewards(const GameState *G);
+
+/**
+ * @brief Suma de las recompensas aún libres.
+ * @param G Puntero al GameState (debe estar mapeado y protegido por read lock).
+ * @return suma de recompensas sin capturar.
+ */
+uint64_t state_remaining_reward_sum(const GameState *G);
+
+/**
+ * @brief Cantidad de celdas sin capturar.
+ * @param G Puntero al GameState (debe estar mapeado y protegido por read lock).
+ * @return celdas libres.
+ */
+uint64_t state_free_cells(const GameState *G);
+
+/**
+ * @brief Celdas capturadas por el jugador i (incluye la de spawn).
+ * @param G Puntero al GameState (debe estar mapeado y protegido por read lock).
+ * @param i índice del jugador.
+ * @return celdas capturadas, 0 si i está fuera de rango.
  */
-int state_remaining_rewards(const GameState *G);
+uint64_t state_captured_cells(const GameState *G, unsigned i);
 
 #endif
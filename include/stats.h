@@ -0,0 +1,169 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "state.h"
+
+#define SHM_GAME_STATS "/game_stats"
+#define STATS_MAGIC "CHSTATS1"
+#define STATS_VERSION 1
+#define STATS_SUB_BITS 5            /* 32 sub-buckets por potencia de 2: error relativo < 3.2% */
+#define STATS_SUB (1u << STATS_SUB_BITS)
+#define STATS_MAX_BITS 42           /* hasta 2^42 ns (~73 min); lo mayor cae en el último bucket */
+#define STATS_BUCKETS ((STATS_MAX_BITS - STATS_SUB_BITS + 1) * STATS_SUB)
+#define STATS_ROW_MASTER MAX_PLAYERS   /* fila de lo que no es de un turno (frame de fin de ronda) */
+#define STATS_ROWS (MAX_PLAYERS + 1)
+
+/**
+ * @brief Latencias que el master mide en cada turno.
+ */
+typedef enum {
+    STAT_GRANT_TO_MOVE = 0,     /**< player_signal_turn hasta que llega el movimiento */
+    STAT_APPLY,                 /**< lock de escritura + validar/aplicar + replay */
+    STAT_RENDER_WAIT,           /**< handshake con la view (o publicar el frame con -F) */
+    STAT_METRICS
+} StatMetric;
+
+/**
+ * @brief Histograma log-lineal (estilo HDR) de latencias en ns.
+ *
+ * Bucket exacto para v < STATS_SUB; desde ahí, STATS_SUB buckets por cada
+ * potencia de 2. Un solo escritor (master): los contadores son atómicos
+ * relajados para que los lectores puedan copiarlos en cualquier momento.
+ */
+typedef struct StatsHist {
+    atomic_uint_least64_t count;
+    atomic_uint_least64_t sum_ns;
+    atomic_uint_least64_t max_ns;
+    atomic_uint_least64_t bucket[STATS_BUCKETS];
+} StatsHist;
+
+/**
+ * @brief Segmento /game_stats: lo escribe el master, chompstat lo mapea de sólo lectura.
+ */
+typedef struct StatsShm {
+    char magic[8];                                  /**< STATS_MAGIC */
+    uint32_t version;                               /**< STATS_VERSION */
+    uint32_t n_players;                             /**< jugadores de la partida */
+    char names[MAX_PLAYERS][NAME_LEN];              /**< nombres (como en GameState) */
+    atomic_uint rounds;                             /**< rondas completas */
+    atomic_uint game_over;                          /**< 1 cuando el master terminó */
+    StatsHist hist[STATS_ROWS][STAT_METRICS];       /**< por jugador (y fila master) y métrica */
+} StatsShm;
+
+/**
+ * @brief Reloj de las mediciones (CLOCK_MONOTONIC en ns, vDSO: sin syscall).
+ * @return instante actual en ns.
+ */
+static inline uint64_t stats_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Bucket de un valor en ns.
+ * @param v valor.
+ * @return índice en bucket[] (0..STATS_BUCKETS-1).
+ */
+static inline unsigned stats_bucket(uint64_t v)
+{
+    if (v < STATS_SUB)
+        return (unsigned)v;
+    unsigned msb = 63u - (unsigned)__builtin_clzll(v);
+    if (msb >= STATS_MAX_BITS)
+        return STATS_BUCKETS - 1;
+    unsigned shift = msb - STATS_SUB_BITS;
+    return (shift + 1) * STATS_SUB + (unsigned)(v >> shift) - STATS_SUB;
+}
+
+/* un solo escritor: load + store relajados, sin read-modify-write atómico */
+static inline void stats_bump(atomic_uint_least64_t *c, uint64_t v)
+{
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + v, memory_order_relaxed);
+}
+
+/**
+ * @brief Registra una latencia (master). Unas pocas instrucciones, sin syscalls ni locks.
+ * @param s segmento (NULL se ignora).
+ * @param row jugador o STATS_ROW_MASTER.
+ * @param m métrica.
+ * @param ns latencia en ns.
+ */
+static inline void stats_record(StatsShm *s, unsigned row, StatMetric m, uint64_t ns)
+{
+    if (!s || row >= STATS_ROWS)
+        return;
+    StatsHist *h = &s->hist[row][m];
+    stats_bump(&h->bucket[stats_bucket(ns)], 1);
+    stats_bump(&h->sum_ns, ns);
+    if (ns > atomic_load_explicit(&h->max_ns, memory_order_relaxed))
+        atomic_store_explicit(&h->max_ns, ns, memory_order_relaxed);
+    stats_bump(&h->count, 1);
+}
+
+/**
+ * @brief Actualiza el contador de rondas (master).
+ * @param s segmento (NULL se ignora).
+ * @param rounds rondas completas.
+ */
+static inline void stats_set_rounds(StatsShm *s, unsigned rounds)
+{
+    if (s)
+        atomic_store_explicit(&s->rounds, rounds, memory_order_relaxed);
+}
+
+/**
+ * @brief Crea /game_stats con los nombres de los jugadores del estado (master).
+ * @param G estado ya inicializado (n_players y nombres).
+ * @return segmento o NULL en error (errno seteado).
+ */
+StatsShm *stats_create(const GameState *G);
+
+/**
+ * @brief Marca el fin de la partida, desmapea y elimina el segmento (master).
+ * @param s segmento (NULL se ignora).
+ */
+void stats_destroy(StatsShm *s);
+
+/**
+ * @brief Mapea /game_stats de sólo lectura (chompstat).
+ * @return segmento o NULL en error (errno seteado; EINVAL si no es un segmento válido).
+ */
+const StatsShm *stats_attach(void);
+
+/**
+ * @brief Desmapea un segmento obtenido con stats_attach.
+ * @param s segmento (NULL se ignora).
+ */
+void stats_detach(const StatsShm *s);
+
+/**
+ * @brief Copia consistente de un histograma, para calcular sin que cambie.
+ */
+typedef struct StatsSnapshot {
+    uint64_t count;                 /**< suma de los buckets copiados */
+    uint64_t sum_ns, max_ns;
+    uint64_t bucket[STATS_BUCKETS];
+} StatsSnapshot;
+
+/**
+ * @brief Copia un histograma mientras el master sigue escribiendo.
+ * @param h histograma en el segmento.
+ * @param[out] out copia (count se recalcula de los buckets).
+ */
+void stats_snapshot(const StatsHist *h, StatsSnapshot *out);
+
+/**
+ * @brief Percentil de una copia, como el mayor valor equivalente del bucket (igual que HDR).
+ * @param s copia.
+ * @param q cuantil en [0, 1].
+ * @return latencia en ns (0 si no hay muestras).
+ */
+uint64_t stats_percentile(const StatsSnapshot *s, double q);
+
+#endif // STATS_H
@@ -2,10 +2,14 @@
 #define SYNC_H
 #include <semaphore.h>
 #include <stddef.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
 
 #define SHM_GAME_SYNC "/game_sync"
 
 #define MAX_PLAYERS 9
+#define MOVE_RING_LEN 16    /* movimientos en vuelo por jugador (potencia de 2) */
 
 /**
  * @brief Crea e inicializa la memoria de sincronización (llamado por el master).
@@ -46,6 +50,48 @@ void wrlock(void);
  */
 void wrunlock(void);
 
+/* --- Lecturas optimistas (seqlock) --- */
+
+/**
+ * @brief Inicia una lectura optimista: espera a que no haya escritura en curso.
+ *
+ * No escribe en memoria compartida. Releer si seq_read_retry() devuelve 1.
+ *
+ * @return número de secuencia observado (par).
+ */
+unsigned seq_read_begin(void);
+
+/**
+ * @brief Valida una lectura optimista.
+ * @param seq valor devuelto por seq_read_begin().
+ * @return 1 si hubo una escritura concurrente (lectura inválida), 0 si es consistente.
+ */
+int seq_read_retry(unsigned seq);
+
+/**
+ * @brief Turno de un jugador: contador de turnos pendientes más palabra futex.
+ *
+ * 'wake' cambia con cada turno otorgado y con cada broadcast, así el jugador
+ * duerme en una sola palabra y no pierde ninguno de los dos avisos.
+ */
+typedef struct TurnSlot {
+    _Alignas(64) atomic_uint wake;   /**< palabra futex del jugador */
+    atomic_uint grants;              /**< turnos otorgados aún no consumidos */
+} TurnSlot;
+
+/**
+ * @brief Anillo SPSC de movimientos jugador -> master (alternativa al pipe).
+ *
+ * head/tail son contadores libres (se comparan por diferencia). El master
+ * duerme en 'head' y el jugador sólo hace futex_wake si 'sleeping' está en 1.
+ */
+typedef struct MoveRing {
+    _Alignas(64) atomic_uint head;   /**< productor: próximo slot a escribir (palabra futex) */
+    atomic_uint sleeping;            /**< el master duerme (o está por dormir) en head */
+    _Alignas(64) atomic_uint tail;   /**< consumidor: próximo slot a leer */
+    uint8_t buf[MOVE_RING_LEN];      /**< bytes de movimiento (mismo formato que el pipe) */
+} MoveRing;
+
 /**
  * @brief Estructura almacenada en la memoria compartida de sincronización.
  *
@@ -53,13 +99,18 @@ void wrunlock(void);
  * actualizaciones y turnos.
  */
 typedef struct SyncMem {
-    sem_t view_update_ready;     /**< master -> view: señal para indicar estado listo */
+    _Alignas(64) atomic_uint state_seq; /**< seqlock: impar mientras el master escribe (línea de caché propia) */
+    _Alignas(64) sem_t view_update_ready; /**< master -> view: señal para indicar estado listo */
     sem_t view_render_complete;  /**< view -> master : opcional, indica render finalizado */
+    atomic_uint view_frames;     /**< 1 si la view lee snapshots del triple buffer (sin semáforos) */
     sem_t writer_mutex;          /**< mutex general para escrituras criticas */
     sem_t state_mutex;           /**< mutex usado para secciones críticas sobre el state */
     sem_t readers_count_mutex;   /**< mutex que protege readers_count */
     unsigned int readers_count;  /**< contador de lectores concurrentes */
-    sem_t player_turns[MAX_PLAYERS]; /**< semáforos por jugador para habilitar turnos */
+    _Alignas(64) atomic_uint broadcast_epoch; /**< se incrementa en game over o al bloquear un jugador */
+    TurnSlot player_turns[MAX_PLAYERS]; /**< turnos por jugador (futex) */
+    _Alignas(64) atomic_uint move_rings; /**< 1 si los jugadores envían por anillo en vez de pipe */
+    MoveRing rings[MAX_PLAYERS];        /**< anillos de movimientos por jugador */
 } SyncMem;
 
 /* --- API master <-> view --- */
@@ -86,6 +137,26 @@ void view_signal_render_complete(void);
  */
 void view_wait_render_complete(void);
 
+/**
+ * @brief Como view_wait_render_complete, pero se rinde tras 'timeout_ms'.
+ *
+ * Permite al master intercalar la espera con la revisión de señales.
+ * @param timeout_ms Espera máxima en milisegundos.
+ * @return 0 si la view terminó de renderizar, -1 si venció el plazo u otro error (errno seteado).
+ */
+int view_wait_render_complete_timed(int timeout_ms);
+
+/**
+ * @brief Activa el modo de frames: la view lee snapshots de SHM_GAME_FRAMES (master, antes de lanzarla).
+ */
+void sync_enable_view_frames(void);
+
+/**
+ * @brief Indica si el master publica frames en vez de usar los semáforos de la view.
+ * @return 1 si el modo de frames está activo, 0 si no.
+ */
+int sync_view_frames_enabled(void);
+
 /* --- API master <-> players (turnos) --- */
 
 /**
@@ -111,6 +182,89 @@ void player_wait_turn(int i);
  */
 int player_wait_turn_timed(int i, int timeout_ms);
 
+/**
+ * @brief Espera el turno o un broadcast del master, lo que ocurra primero.
+ *
+ * @param i índice del jugador (0..MAX_PLAYERS-1)
+ * @param[in,out] epoch época ya vista; se actualiza si hubo broadcast.
+ * @return  1 si el turno fue otorgado,
+ *          0 si hubo broadcast (releer game_over/blocked),
+ *         -1 en caso de error (errno seteado).
+ */
+int player_wait_turn_or_broadcast(int i, unsigned *epoch);
+
+/* --- Transporte de movimientos player -> master --- */
+
+/**
+ * @brief Activa los anillos de movimientos (master, antes de lanzar a los jugadores).
+ */
+void sync_enable_move_rings(void);
+
+/**
+ * @brief Indica si el master activó los anillos de movimientos.
+ * @return 1 si están activos, 0 si los movimientos van por pipe.
+ */
+int sync_move_rings_enabled(void);
+
+/**
+ * @brief Envía un movimiento al master (player side).
+ *
+ * Con anillos activos escribe en el anillo del jugador sin syscalls salvo
+ * que el master esté dormido; si no, escribe el byte en stdout (el pipe).
+ * @param i índice del jugador (0..MAX_PLAYERS-1)
+ * @param mv byte de movimiento (dirección o pase).
+ * @return 0 en éxito, -1 en error (errno = EAGAIN si el anillo está lleno).
+ */
+int player_send_move(int i, uint8_t mv);
+
+/**
+ * @brief Saca el próximo movimiento del anillo del jugador i (master).
+ * @param i índice del jugador.
+ * @param[out] mv recibe el byte.
+ * @return 1 si había un movimiento, 0 si el anillo estaba vacío.
+ */
+int move_ring_pop(int i, uint8_t *mv);
+
+/**
+ * @brief Indica si el anillo del jugador i tiene movimientos pendientes (master).
+ * @param i índice del jugador.
+ * @return 1 si hay pendientes, 0 si está vacío.
+ */
+int move_ring_pending(int i);
+
+/**
+ * @brief Espera a que el anillo del jugador i tenga un movimiento (master).
+ *
+ * Con varias CPUs primero espera activamente un instante; después duerme en
+ * el futex del anillo.
+ * @param i índice del jugador.
+ * @param deadline instante absoluto CLOCK_MONOTONIC (NULL = sin límite).
+ * @return 1 si hay un movimiento pendiente, 0 si venció el plazo o hubo una señal.
+ */
+int move_ring_wait(int i, const struct timespec *deadline);
+
+/* --- Broadcast master -> todos (game over, jugador bloqueado) --- */
+
+/**
+ * @brief Incrementa la época y despierta a todos los que esperan turno o broadcast.
+ *
+ * Llamar después de publicar el cambio (game_over o blocked) en el estado.
+ */
+void sync_broadcast(void);
+
+/**
+ * @brief Devuelve la época actual de broadcast.
+ *
+ * Leerla antes de chequear el estado, así un broadcast posterior no se pierde.
+ */
+unsigned sync_broadcast_epoch(void);
+
+/**
+ * @brief Bloquea hasta que la época difiera de *epoch.
+ * @param[in,out] epoch época ya vista; recibe la nueva.
+ */
+void sync_wait_broadcast(unsigned *epoch);
+
 
 
 #endif
@@ -0,0 +1,62 @@
+#ifndef VORONOI_H
+#define VORONOI_H
+
+#include <stdint.h>
+#include "state.h"
+
+/**
+ * @brief Territorio de cada jugador: celdas libres a las que llega antes que nadie.
+ */
+typedef struct VoronoiResult {
+    uint64_t cells[MAX_PLAYERS];    /**< @brief celdas alcanzadas primero por cada jugador */
+    uint64_t reward[MAX_PLAYERS];   /**< @brief suma de recompensas de esas celdas */
+    uint64_t contested;             /**< @brief celdas alcanzadas a la vez por dos o más (de nadie) */
+    unsigned steps;                 /**< @brief pasos de BFS ejecutados */
+} VoronoiResult;
+
+/**
+ * @brief Buffers reutilizables del evaluador (planos de bits por jugador).
+ *
+ * Se dimensionan para un tablero y se limpian sólo en la zona tocada, así una
+ * evaluación acotada por max_steps no paga el tamaño completo del tablero.
+ */
+typedef struct VoronoiWork {
+    unsigned w, h;
+    size_t words;                   /**< @brief palabras de 64 bits por fila */
+    uint64_t *claimed;              /**< @brief celdas ya asignadas (o cabezas) */
+    uint64_t *front[MAX_PLAYERS];   /**< @brief frente actual de cada jugador */
+    uint64_t *next[MAX_PLAYERS];    /**< @brief frente candidato del paso en curso */
+    uint64_t *mem;
+} VoronoiWork;
+
+/**
+ * @brief Inicializa buffers vacíos (se reservan en la primera evaluación).
+ * @param vw Buffers a inicializar.
+ */
+void voronoi_work_init(VoronoiWork *vw);
+
+/**
+ * @brief Libera los buffers.
+ * @param vw Buffers a liberar.
+ */
+void voronoi_work_free(VoronoiWork *vw);
+
+/**
+ * @brief BFS multi-fuente (8-conectado) desde las cabezas de todos los jugadores no bloqueados.
+ *
+ * Todos los frentes avanzan un paso por iteración como máscaras de bits por
+ * fila sobre el plano de ocupación; una celda alcanzada por dos jugadores en
+ * el mismo paso queda neutral y no propaga.
+ * @param vw Buffers de trabajo.
+ * @param G Estado del juego (lectura).
+ * @param mover Jugador cuya cabeza se reemplaza por (mx,my) para evaluar una jugada; -1 = ninguno.
+ * @param mx Columna de la cabeza hipotética de mover.
+ * @param my Fila de la cabeza hipotética de mover.
+ * @param max_steps Horizonte en pasos (0 = hasta agotar los frentes).
+ * @param[out] out Territorio por jugador.
+ * @return 0 si OK, -1 si no hubo memoria.
+ */
+int voronoi_eval(VoronoiWork *vw, const GameState *G, int mover, unsigned mx, unsigned my,
+                 unsigned max_steps, VoronoiResult *out);
+
+#endif // VORONOI_H
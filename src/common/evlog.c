@@ -0,0 +1,238 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include "evlog.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RING_MASK (EVLOG_RING_LEN - 1)
+#define DRAIN_BATCH 256
+#define NANOSEC_PER_SEC 1000000000L
+#define NANOSEC_PER_MILLISEC 1000000L
+
+/* anillo acotado multi-productor (secuencia por slot), un solo consumidor: el hilo escritor */
+typedef struct {
+    atomic_uint seq;
+    EvRecord r;
+} Slot;
+
+static Slot ring[EVLOG_RING_LEN];
+static atomic_uint enq_pos;
+static unsigned deq_pos;
+static atomic_int cur_level = EVLOG_OFF;
+static atomic_uint dropped;
+static atomic_int stopping;
+static pthread_t writer;
+static int fd = -1;
+
+static int write_all(const void *buf, size_t len)
+{
+    const char *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = write(fd, p, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static unsigned drain(EvRecord *out, unsigned max)
+{
+    unsigned n = 0;
+    while (n < max)
+    {
+        Slot *s = &ring[deq_pos & RING_MASK];
+        if (atomic_load_explicit(&s->seq, memory_order_acquire) != deq_pos + 1)
+            break;
+        out[n++] = s->r;
+        /* el slot vuelve a estar libre para la vuelta siguiente del anillo */
+        atomic_store_explicit(&s->seq, deq_pos + EVLOG_RING_LEN, memory_order_release);
+        deq_pos++;
+    }
+    return n;
+}
+
+uint64_t evlog_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NANOSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/* deja constancia de los descartes desde la última vez (lo escribe el propio hilo) */
+static void report_drops(unsigned *reported)
+{
+    unsigned d = atomic_load_explicit(&dropped, memory_order_relaxed);
+    if (d == *reported)
+        return;
+    EvRecord r;
+    memset(&r, 0, sizeof(r));
+    r.t_ns = evlog_clock_ns();
+    r.kind = EV_DROPPED;
+    r.level = EVLOG_ERROR;
+    r.arg[0] = d - *reported;
+    *reported = d;
+    (void)write_all(&r, sizeof(r));
+}
+
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    EvRecord batch[DRAIN_BATCH];
+    unsigned reported = 0;
+    for (;;)
+    {
+        unsigned n = drain(batch, DRAIN_BATCH);
+        if (n > 0)
+        {
+            (void)write_all(batch, n * sizeof(EvRecord));
+            continue;
+        }
+        report_drops(&reported);
+        if (atomic_load_explicit(&stopping, memory_order_acquire))
+        {
+            /* un último pase: lo encolado antes de pedir el cierre ya es visible */
+            while ((n = drain(batch, DRAIN_BATCH)) > 0)
+                (void)write_all(batch, n * sizeof(EvRecord));
+            report_drops(&reported);
+            return NULL;
+        }
+        struct timespec ts = {.tv_sec = 0, .tv_nsec = EVLOG_DRAIN_MS * NANOSEC_PER_MILLISEC};
+        nanosleep(&ts, NULL);
+    }
+}
+
+int evlog_open(const char *path, int level)
+{
+    if (level <= EVLOG_OFF)
+        return 0;
+    fd = open(path, O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return -1;
+
+    EvFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, EVLOG_MAGIC, sizeof(h.magic));
+    h.version = EVLOG_VERSION;
+    h.record_size = sizeof(EvRecord);
+    if (write_all(&h, sizeof(h)) != 0)
+    {
+        close(fd);
+        fd = -1;
+        return -1;
+    }
+
+    for (unsigned i = 0; i < EVLOG_RING_LEN; ++i)
+        atomic_init(&ring[i].seq, i);
+    atomic_store(&enq_pos, 0);
+    deq_pos = 0;
+    atomic_store(&dropped, 0);
+    atomic_store(&stopping, 0);
+    int err = pthread_create(&writer, NULL, writer_main, NULL);
+    if (err != 0)
+    {
+        close(fd);
+        fd = -1;
+        errno = err;
+        return -1;
+    }
+    atomic_store_explicit(&cur_level, level, memory_order_release);
+    return 0;
+}
+
+void evlog_close(void)
+{
+    if (fd == -1)
+        return;
+    atomic_store_explicit(&cur_level, EVLOG_OFF, memory_order_release);
+    atomic_store_explicit(&stopping, 1, memory_order_release);
+    pthread_join(writer, NULL);
+    close(fd);
+    fd = -1;
+}
+
+int evlog_enabled(int level)
+{
+    return level <= atomic_load_explicit(&cur_level, memory_order_relaxed);
+}
+
+void evlog_emit(int level, int kind, unsigned player, unsigned round,
+                uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    if (!evlog_enabled(level))
+        return;
+    unsigned pos = atomic_load_explicit(&enq_pos, memory_order_relaxed);
+    Slot *s;
+    for (;;)
+    {
+        s = &ring[pos & RING_MASK];
+        unsigned seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&enq_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            /* lleno: el hilo escritor no da abasto; nunca se bloquea al llamador */
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&enq_pos, memory_order_relaxed);
+        }
+    }
+    s->r.t_ns = evlog_clock_ns();
+    s->r.kind = (uint16_t)kind;
+    s->r.level = (uint8_t)level;
+    s->r.player = (uint8_t)player;
+    s->r.round = round;
+    s->r.arg[0] = a0;
+    s->r.arg[1] = a1;
+    s->r.arg[2] = a2;
+    s->r.arg[3] = a3;
+    atomic_store_explicit(&s->seq, pos + 1, memory_order_release);
+}
+
+int evlog_parse_level(const char *s, int *out)
+{
+    static const char *names[] = {"off", "error", "info"};
+    for (int i = 0; i < 3; ++i)
+        if (strcasecmp(s, names[i]) == 0)
+        {
+            *out = i - 1;
+            return 0;
+        }
+    char *end = NULL;
+    long v = strtol(s, &end, 10);
+    if (end == s || *end != '\0' || v < EVLOG_OFF || v > EVLOG_INFO)
+        return -1;
+    *out = (int)v;
+    return 0;
+}
+
+int evlog_level_from_env(int def)
+{
+    const char *s = getenv(EVLOG_LEVEL_ENV);
+    int level;
+    if (s == NULL || evlog_parse_level(s, &level) != 0)
+        return def;
+    return level;
+}
@@ -0,0 +1,189 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include "frames.h"
+#include "shm.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#define FRAME_HDR_BYTES 64
+#define NANOSEC_PER_SEC 1000000000ull
+
+_Static_assert(sizeof(FrameHeader) <= FRAME_HDR_BYTES, "FrameHeader no entra en su línea");
+
+struct FrameWriter {
+    FrameHeader *hdr;
+    size_t map_bytes;
+    unsigned back;          /* slot que escribe el master */
+    uint64_t gen;           /* publicaciones hechas */
+    uint64_t *row_gen;      /* por fila: publicación en la que cambió por última vez */
+    uint64_t interval_ns;
+    uint64_t last_ns;
+};
+
+struct FrameReader {
+    FrameHeader *hdr;
+    size_t map_bytes;
+    unsigned front;         /* slot que está mostrando la view */
+};
+
+static uint64_t clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NANOSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t *slot_seq(FrameHeader *hdr, unsigned k)
+{
+    return (uint64_t *)(void *)((char *)hdr + FRAME_HDR_BYTES + (size_t)k * hdr->slot_bytes);
+}
+
+static inline GameState *slot_state(FrameHeader *hdr, unsigned k)
+{
+    return (GameState *)(void *)((char *)slot_seq(hdr, k) + FRAME_SLOT_HDR);
+}
+
+FrameWriter *frames_create(const GameState *G, unsigned fps)
+{
+    if (fps == 0)
+        fps = FRAMES_DEFAULT_FPS;
+    size_t state_bytes = state_size(G->w, G->h, (CellFormat)G->cell_format);
+    size_t slot_bytes = (FRAME_SLOT_HDR + state_bytes + 63) & ~(size_t)63;
+
+    FrameWriter *fw = calloc(1, sizeof(*fw));
+    if (!fw)
+        return NULL;
+    fw->row_gen = malloc((size_t)G->h * sizeof(uint64_t));
+    if (!fw->row_gen)
+    {
+        free(fw);
+        return NULL;
+    }
+    fw->map_bytes = FRAME_HDR_BYTES + FRAME_SLOTS * slot_bytes;
+    fw->hdr = shm_create_map(SHM_GAME_FRAMES, fw->map_bytes, PROT_READ | PROT_WRITE);
+    if (!fw->hdr)
+    {
+        free(fw->row_gen);
+        free(fw);
+        return NULL;
+    }
+
+    FrameHeader *hdr = fw->hdr;
+    hdr->w = G->w;
+    hdr->h = G->h;
+    hdr->cell_format = G->cell_format;
+    hdr->fps = fps;
+    hdr->slot_bytes = slot_bytes;
+    /* master escribe en 0, la view arranca mostrando 2, el 1 queda listo (vacío) */
+    atomic_init(&hdr->ready, 1);
+    fw->back = 0;
+    /* slots recién creados (seq 0): la primera publicación en cada uno copia todo */
+    for (unsigned y = 0; y < G->h; ++y)
+        fw->row_gen[y] = 1;
+    fw->interval_ns = NANOSEC_PER_SEC / fps;
+    return fw;
+}
+
+void frames_mark_row(FrameWriter *fw, unsigned y)
+{
+    if (fw && y < fw->hdr->h)
+        fw->row_gen[y] = fw->gen + 1;
+}
+
+int frames_publish(FrameWriter *fw, const GameState *G, int force)
+{
+    if (!fw)
+        return 0;
+    uint64_t now = clock_ns();
+    if (!force && now - fw->last_ns < fw->interval_ns)
+        return 0;
+
+    FrameHeader *hdr = fw->hdr;
+    GameState *dst = slot_state(hdr, fw->back);
+    uint64_t *seq = slot_seq(hdr, fw->back);
+    const uint64_t have = *seq;
+
+    /* jugadores, agregados y flags; el tablero sólo en las filas que cambiaron desde 'have' */
+    memcpy(dst, G, offsetof(GameState, board));
+    const size_t row_bytes = (size_t)G->w * cell_bytes(G->cell_format);
+    const size_t occ_row_bytes = occ_words_per_row(G->w) * sizeof(uint64_t);
+    for (unsigned y = 0; y < G->h; ++y)
+    {
+        if (fw->row_gen[y] <= have)
+            continue;
+        memcpy((char *)dst->board + (size_t)y * row_bytes, (const char *)G->board + (size_t)y * row_bytes, row_bytes);
+        memcpy(occ_row_mut(dst, y), occ_row(G, y), occ_row_bytes);
+    }
+    *seq = ++fw->gen;
+
+    unsigned old = atomic_exchange_explicit(&hdr->ready, fw->back | FRAME_FRESH, memory_order_acq_rel);
+    fw->back = old & ~FRAME_FRESH;
+    fw->last_ns = now;
+    return 1;
+}
+
+void frames_destroy(FrameWriter *fw)
+{
+    if (!fw)
+        return;
+    shm_unmap(fw->hdr, fw->map_bytes);
+    shm_remove_name(SHM_GAME_FRAMES);
+    free(fw->row_gen);
+    free(fw);
+}
+
+FrameReader *frames_attach(void)
+{
+    size_t size = 0;
+    FrameHeader *hdr = shm_attach_map(SHM_GAME_FRAMES, &size, PROT_READ | PROT_WRITE);
+    if (!hdr)
+        return NULL;
+    if (size < FRAME_HDR_BYTES || hdr->slot_bytes == 0 ||
+        size < FRAME_HDR_BYTES + FRAME_SLOTS * hdr->slot_bytes)
+    {
+        shm_unmap(hdr, size);
+        errno = EINVAL;
+        return NULL;
+    }
+    FrameReader *fr = calloc(1, sizeof(*fr));
+    if (!fr)
+    {
+        shm_unmap(hdr, size);
+        return NULL;
+    }
+    fr->hdr = hdr;
+    fr->map_bytes = size;
+    fr->front = 2;
+    return fr;
+}
+
+unsigned frames_fps(const FrameReader *fr)
+{
+    return fr->hdr->fps ? fr->hdr->fps : FRAMES_DEFAULT_FPS;
+}
+
+GameState *frames_latest(FrameReader *fr, uint64_t *seq)
+{
+    FrameHeader *hdr = fr->hdr;
+    if (!(atomic_load_explicit(&hdr->ready, memory_order_acquire) & FRAME_FRESH))
+        return NULL;
+    /* devolver el que se estaba mostrando y quedarse con el listo */
+    unsigned old = atomic_exchange_explicit(&hdr->ready, fr->front, memory_order_acq_rel);
+    fr->front = old & ~FRAME_FRESH;
+    if (seq)
+        *seq = *slot_seq(hdr, fr->front);
+    return slot_state(hdr, fr->front);
+}
+
+void frames_detach(FrameReader *fr)
+{
+    if (!fr)
+        return;
+    shm_unmap(fr->hdr, fr->map_bytes);
+    free(fr);
+}
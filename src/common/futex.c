@@ -0,0 +1,39 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include "futex.h"
+#include <errno.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define MILLISEC_PER_SEC 1000
+#define NANOSEC_PER_MILLISEC 1000000L
+#define NANOSEC_PER_SEC 1000000000L
+
+int futex_wait(atomic_uint *word, unsigned expected, const struct timespec *deadline)
+{
+    /* WAIT_BITSET acepta un timeout absoluto en CLOCK_MONOTONIC (no se estira con reintentos) */
+    long r = syscall(SYS_futex, (unsigned *)word, FUTEX_WAIT_BITSET, expected,
+                     deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+    if (r == 0 || errno == EAGAIN)
+        return 0;
+    return -1;
+}
+
+int futex_wake(atomic_uint *word, int n)
+{
+    return (int)syscall(SYS_futex, (unsigned *)word, FUTEX_WAKE, n, NULL, NULL, 0);
+}
+
+void futex_deadline_ms(struct timespec *ts, int timeout_ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout_ms / MILLISEC_PER_SEC;
+    ts->tv_nsec += (long)(timeout_ms % MILLISEC_PER_SEC) * NANOSEC_PER_MILLISEC;
+    if (ts->tv_nsec >= NANOSEC_PER_SEC)
+    {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= NANOSEC_PER_SEC;
+    }
+}
@@ -0,0 +1,622 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include "replay.h"
+#include "rules.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#define INDEX_MAGIC "CHRI"
+#define WRITE_BUF_BYTES (1 << 16)
+#define VARINT_MAX_BYTES 10
+#define KEY_PLAYER_FIELDS 7
+
+/*
+ * Byte de evento:
+ *   bit0 = 1  -> jugada válida: dirección en bits 1..3, jugador en bits 4..7
+ *   bit0 = 0  -> tipo en bits 1..2 (REC_*), jugador o subtipo especial en bits 3..7
+ * Una inválida lleva además el byte recibido; un keyframe, varint largo + payload.
+ */
+enum { REC_INVALID = 0, REC_PASS = 1, REC_TIMEOUT = 2, REC_SPECIAL = 3 };
+enum { SPECIAL_KEYFRAME = 0, SPECIAL_END = 1 };
+
+typedef struct {
+    uint64_t move;      /* jugadas aplicadas al tomar el keyframe */
+    uint64_t offset;    /* offset del byte de evento del keyframe */
+} IndexEntry;
+
+typedef struct {
+    uint64_t index_offset;
+    uint64_t moves;
+    uint32_t count;
+    char magic[4];
+} IndexTrailer;
+
+/* buffer creciente para armar (o leer) el payload de un keyframe */
+typedef struct {
+    uint8_t *p;
+    size_t len, cap;
+} Buf;
+
+struct ReplayWriter {
+    FILE *f;
+    uint64_t pos;               /* bytes escritos */
+    uint64_t moves;
+    uint64_t last_key_move;
+    unsigned key_interval;
+    IndexEntry *index;
+    unsigned count, cap;
+    Buf kbuf;
+    int err;
+};
+
+struct ReplayReader {
+    FILE *f;
+    ReplayHeader h;
+    uint64_t data_start;
+    uint64_t moves;
+    IndexEntry *index;
+    unsigned count;
+    Buf kbuf;
+    GameState *base;            /* tablero de la semilla, generado una sola vez */
+};
+
+/* --- varints (LEB128 sin signo) --- */
+
+static int buf_reserve(Buf *b, size_t extra)
+{
+    if (b->len + extra <= b->cap)
+        return 0;
+    size_t cap = b->cap ? b->cap : 256;
+    while (cap < b->len + extra)
+        cap *= 2;
+    uint8_t *p = realloc(b->p, cap);
+    if (!p)
+        return -1;
+    b->p = p;
+    b->cap = cap;
+    return 0;
+}
+
+static int buf_varint(Buf *b, uint64_t v)
+{
+    if (buf_reserve(b, VARINT_MAX_BYTES) != 0)
+        return -1;
+    while (v >= 0x80)
+    {
+        b->p[b->len++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    b->p[b->len++] = (uint8_t)v;
+    return 0;
+}
+
+static int mem_varint(const uint8_t **p, const uint8_t *end, uint64_t *out)
+{
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64 && *p < end; shift += 7)
+    {
+        uint8_t c = *(*p)++;
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80))
+        {
+            *out = v;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int file_varint(FILE *f, uint64_t *out)
+{
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        int c = getc(f);
+        if (c == EOF)
+            return -1;
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80))
+        {
+            *out = v;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* --- writer --- */
+
+static void w_bytes(ReplayWriter *rw, const void *p, size_t n)
+{
+    if (fwrite(p, 1, n, rw->f) != n)
+        rw->err = 1;
+    rw->pos += n;
+}
+
+static void w_varint(ReplayWriter *rw, uint64_t v)
+{
+    uint8_t tmp[VARINT_MAX_BYTES];
+    size_t n = 0;
+    while (v >= 0x80)
+    {
+        tmp[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    tmp[n++] = (uint8_t)v;
+    w_bytes(rw, tmp, n);
+}
+
+/* celdas capturadas en orden lineal (gap << 4 | dueño) y la tabla de jugadores */
+static int encode_keyframe(Buf *b, const GameState *G, uint64_t move)
+{
+    b->len = 0;
+    uint64_t captured = 0;
+    for (unsigned i = 0; i < G->n_players; ++i)
+        captured += G->stats.captured[i];
+    if (buf_varint(b, move) != 0 || buf_varint(b, captured) != 0)
+        return -1;
+
+    const size_t words = occ_words_per_row(G->w);
+    uint64_t prev = 0;
+    for (unsigned y = 0; y < G->h; ++y)
+    {
+        const uint64_t *row = occ_row(G, y);
+        for (size_t k = 0; k < words; ++k)
+            for (uint64_t bits = row[k]; bits; bits &= bits - 1)
+            {
+                unsigned x = (unsigned)(k * OCC_WORD_BITS) + (unsigned)__builtin_ctzll(bits);
+                uint64_t i = idx(G, x, y);
+                int owner = cell_owner(cell_get(G, i));
+                if (buf_varint(b, (i - prev) << 4 | (uint64_t)(owner & 0xF)) != 0)
+                    return -1;
+                prev = i;
+            }
+    }
+
+    for (unsigned i = 0; i < G->n_players; ++i)
+    {
+        const Player *p = &G->P[i];
+        uint64_t f[KEY_PLAYER_FIELDS] = {p->score, p->valids, p->invalids, p->timeouts, p->x, p->y, p->blocked};
+        for (int k = 0; k < KEY_PLAYER_FIELDS; ++k)
+            if (buf_varint(b, f[k]) != 0)
+                return -1;
+    }
+    return 0;
+}
+
+static void write_keyframe(ReplayWriter *rw, const GameState *G)
+{
+    if (encode_keyframe(&rw->kbuf, G, rw->moves) != 0)
+    {
+        rw->err = 1;
+        return;
+    }
+    if (rw->count == rw->cap)
+    {
+        unsigned cap = rw->cap ? rw->cap * 2 : 64;
+        IndexEntry *n = realloc(rw->index, cap * sizeof(*n));
+        if (!n)
+        {
+            rw->err = 1;
+            return;
+        }
+        rw->index = n;
+        rw->cap = cap;
+    }
+    rw->index[rw->count].move = rw->moves;
+    rw->index[rw->count].offset = rw->pos;
+    rw->count++;
+
+    uint8_t tag = (uint8_t)(REC_SPECIAL << 1 | SPECIAL_KEYFRAME << 3);
+    w_bytes(rw, &tag, 1);
+    w_varint(rw, rw->kbuf.len);
+    w_bytes(rw, rw->kbuf.p, rw->kbuf.len);
+    rw->last_key_move = rw->moves;
+}
+
+unsigned replay_key_interval(const GameState *G, unsigned max_rounds)
+{
+    uint64_t moves = (uint64_t)max_rounds * G->n_players;
+    uint64_t cells = (uint64_t)G->w * G->h;
+    if (cells < moves)
+        moves = cells;
+    uint64_t k = moves / REPLAY_KEYS_PER_GAME;
+    return k > REPLAY_KEY_MIN_INTERVAL ? (unsigned)(k < UINT32_MAX ? k : UINT32_MAX) : REPLAY_KEY_MIN_INTERVAL;
+}
+
+ReplayWriter *replay_create(const char *path, const GameState *G, unsigned seed, unsigned key_interval)
+{
+    ReplayWriter *rw = calloc(1, sizeof(*rw));
+    if (!rw)
+        return NULL;
+    rw->f = fopen(path, "wb");
+    if (!rw->f)
+    {
+        free(rw);
+        return NULL;
+    }
+    /* los eventos son de 1 byte: que lleguen al archivo en bloques grandes */
+    setvbuf(rw->f, NULL, _IOFBF, WRITE_BUF_BYTES);
+    rw->key_interval = key_interval ? key_interval : REPLAY_KEY_MIN_INTERVAL;
+
+    ReplayHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, REPLAY_MAGIC, sizeof(h.magic));
+    h.version = REPLAY_VERSION;
+    h.board_gen = REPLAY_BOARD_GEN;
+    h.w = G->w;
+    h.h = G->h;
+    h.n_players = G->n_players;
+    h.cell_format = G->cell_format;
+    h.seed = seed;
+    h.key_interval = rw->key_interval;
+    for (unsigned i = 0; i < G->n_players && i < MAX_PLAYERS; ++i)
+    {
+        h.start_x[i] = G->P[i].x;
+        h.start_y[i] = G->P[i].y;
+        memcpy(h.names[i], G->P[i].name, NAME_LEN);
+    }
+    w_bytes(rw, &h, sizeof(h));
+    if (rw->err)
+    {
+        fclose(rw->f);
+        free(rw);
+        return NULL;
+    }
+    return rw;
+}
+
+void replay_record(ReplayWriter *rw, const GameState *G, unsigned player, ReplayOutcome outcome, uint8_t mv)
+{
+    if (!rw)
+        return;
+    uint8_t b;
+    switch (outcome)
+    {
+    case REPLAY_VALID:
+        b = (uint8_t)(1u | (mv & 7u) << 1 | player << 4);
+        w_bytes(rw, &b, 1);
+        break;
+    case REPLAY_INVALID:
+        b = (uint8_t)(REC_INVALID << 1 | player << 3);
+        w_bytes(rw, &b, 1);
+        w_bytes(rw, &mv, 1);
+        break;
+    case REPLAY_PASS:
+        b = (uint8_t)(REC_PASS << 1 | player << 3);
+        w_bytes(rw, &b, 1);
+        break;
+    case REPLAY_TIMEOUT:
+        b = (uint8_t)(REC_TIMEOUT << 1 | player << 3);
+        w_bytes(rw, &b, 1);
+        break;
+    }
+    rw->moves++;
+
+    /* espaciado fijo: un seek nunca reproduce más de key_interval jugadas */
+    if (rw->moves - rw->last_key_move >= rw->key_interval)
+        write_keyframe(rw, G);
+}
+
+int replay_close(ReplayWriter *rw)
+{
+    if (!rw)
+        return 0;
+    uint8_t tag = (uint8_t)(REC_SPECIAL << 1 | SPECIAL_END << 3);
+    w_bytes(rw, &tag, 1);
+
+    IndexTrailer t;
+    memset(&t, 0, sizeof(t));
+    t.index_offset = rw->pos;
+    t.moves = rw->moves;
+    t.count = rw->count;
+    memcpy(t.magic, INDEX_MAGIC, sizeof(t.magic));
+    if (rw->count > 0)
+        w_bytes(rw, rw->index, rw->count * sizeof(IndexEntry));
+    w_bytes(rw, &t, sizeof(t));
+
+    int rc = rw->err ? -1 : 0;
+    if (fclose(rw->f) != 0)
+        rc = -1;
+    free(rw->index);
+    free(rw->kbuf.p);
+    free(rw);
+    return rc;
+}
+
+/* --- reader --- */
+
+/* recorre el stream desde el inicio armando el índice (replay sin trailer) */
+static int scan_index(ReplayReader *r)
+{
+    unsigned cap = 0;
+    if (fseeko(r->f, 0, SEEK_END) != 0)
+        return -1;
+    const off_t size = ftello(r->f);
+    if (fseeko(r->f, (off_t)r->data_start, SEEK_SET) != 0)
+        return -1;
+    uint64_t moves = 0;
+    for (;;)
+    {
+        off_t at = ftello(r->f);
+        int c = getc(r->f);
+        if (c == EOF)
+            break;
+        if ((c & 1) || ((c >> 1) & 3) != REC_SPECIAL)
+        {
+            if (!(c & 1) && ((c >> 1) & 3) == REC_INVALID && getc(r->f) == EOF)
+                break;
+            moves++;
+            continue;
+        }
+        if ((c >> 3) == SPECIAL_END)
+            break;
+        uint64_t len;
+        /* un keyframe cortado por el final del archivo no se indexa */
+        if (file_varint(r->f, &len) != 0 || (uint64_t)(size - ftello(r->f)) < len ||
+            fseeko(r->f, (off_t)len, SEEK_CUR) != 0)
+            break;
+        if (r->count == cap)
+        {
+            cap = cap ? cap * 2 : 64;
+            IndexEntry *n = realloc(r->index, cap * sizeof(*n));
+            if (!n)
+                return -1;
+            r->index = n;
+        }
+        r->index[r->count].move = moves;
+        r->index[r->count].offset = (uint64_t)at;
+        r->count++;
+    }
+    r->moves = moves;
+    return 0;
+}
+
+static int load_index(ReplayReader *r)
+{
+    IndexTrailer t;
+    if (fseeko(r->f, -(off_t)sizeof(t), SEEK_END) != 0 || fread(&t, sizeof(t), 1, r->f) != 1 ||
+        memcmp(t.magic, INDEX_MAGIC, sizeof(t.magic)) != 0)
+        return -1;
+    if (t.count > 0)
+    {
+        r->index = malloc(t.count * sizeof(IndexEntry));
+        if (!r->index || fseeko(r->f, (off_t)t.index_offset, SEEK_SET) != 0 ||
+            fread(r->index, sizeof(IndexEntry), t.count, r->f) != t.count)
+        {
+            free(r->index);
+            r->index = NULL;
+            return -1;
+        }
+    }
+    r->count = t.count;
+    r->moves = t.moves;
+    return 0;
+}
+
+ReplayReader *replay_open(const char *path)
+{
+    ReplayReader *r = calloc(1, sizeof(*r));
+    if (!r)
+        return NULL;
+    r->f = fopen(path, "rb");
+    if (!r->f)
+    {
+        perror(path);
+        free(r);
+        return NULL;
+    }
+    const ReplayHeader *h = &r->h;
+    if (fread(&r->h, sizeof(r->h), 1, r->f) != 1 || memcmp(h->magic, REPLAY_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != REPLAY_VERSION)
+    {
+        fprintf(stderr, "%s: no es un replay (o versión no soportada)\n", path);
+        replay_free(r);
+        return NULL;
+    }
+    if (h->board_gen != REPLAY_BOARD_GEN)
+    {
+        fprintf(stderr, "%s: tablero generado con otra versión (%u, esta es %u)\n", path, h->board_gen, REPLAY_BOARD_GEN);
+        replay_free(r);
+        return NULL;
+    }
+    if (h->n_players == 0 || h->n_players > MAX_PLAYERS ||
+        state_size_checked(h->w, h->h, (CellFormat)h->cell_format, NULL) != 0)
+    {
+        fprintf(stderr, "%s: cabecera inválida\n", path);
+        replay_free(r);
+        return NULL;
+    }
+    r->data_start = sizeof(r->h);
+    if (load_index(r) != 0 && scan_index(r) != 0)
+    {
+        fprintf(stderr, "%s: no se pudo leer el índice\n", path);
+        replay_free(r);
+        return NULL;
+    }
+    return r;
+}
+
+void replay_free(ReplayReader *r)
+{
+    if (!r)
+        return;
+    if (r->f)
+        fclose(r->f);
+    free(r->index);
+    free(r->kbuf.p);
+    free(r->base);
+    free(r);
+}
+
+const ReplayHeader *replay_header(const ReplayReader *r) { return &r->h; }
+
+uint64_t replay_moves(const ReplayReader *r) { return r->moves; }
+
+unsigned replay_keyframes(const ReplayReader *r) { return r->count; }
+
+uint64_t replay_keyframe_move(const ReplayReader *r, unsigned k) { return r->index[k].move; }
+
+/* tablero inicial de la semilla, sin jugadores ubicados; se copia de r->base */
+static int base_state(ReplayReader *r, GameState *G)
+{
+    const size_t bytes = state_size(r->h.w, r->h.h, (CellFormat)r->h.cell_format);
+    if (!r->base)
+    {
+        r->base = state_alloc(r->h.w, r->h.h, (CellFormat)r->h.cell_format);
+        if (!r->base)
+            return -1;
+        state_zero(r->base, r->h.w, r->h.h, r->h.n_players);
+        board_fill_rewards(r->base, r->h.seed);
+        for (unsigned i = 0; i < r->h.n_players; ++i)
+            memcpy(r->base->P[i].name, r->h.names[i], NAME_LEN);
+    }
+    memcpy(G, r->base, bytes);
+    return 0;
+}
+
+static void capture(GameState *G, uint64_t i, int owner)
+{
+    unsigned x = (unsigned)(i % G->w), y = (unsigned)(i / G->w);
+    stats_on_capture(G, owner, cell_reward(cell_get(G, (size_t)i)));
+    cell_set(G, (size_t)i, make_captured(owner));
+    occ_set(G, x, y);
+}
+
+/* jugada 0: como la deja el master antes del primer turno */
+static int restore_initial(ReplayReader *r, GameState *G)
+{
+    if (base_state(r, G) != 0)
+        return -1;
+    for (unsigned i = 0; i < r->h.n_players; ++i)
+    {
+        G->P[i].x = r->h.start_x[i];
+        G->P[i].y = r->h.start_y[i];
+        capture(G, idx(G, G->P[i].x, G->P[i].y), (int)i);
+    }
+    for (unsigned i = 0; i < r->h.n_players; ++i)
+        G->P[i].blocked = !player_can_move(G, (int)i);
+    return 0;
+}
+
+/* lee el keyframe en la posición actual (ya consumido el byte de evento) y lo aplica a G */
+static int restore_keyframe(ReplayReader *r, GameState *G)
+{
+    uint64_t len;
+    if (file_varint(r->f, &len) != 0)
+        return -1;
+    r->kbuf.len = 0;
+    if (buf_reserve(&r->kbuf, (size_t)len) != 0 || fread(r->kbuf.p, 1, (size_t)len, r->f) != len)
+        return -1;
+    const uint8_t *p = r->kbuf.p, *end = r->kbuf.p + len;
+
+    if (base_state(r, G) != 0)
+        return -1;
+    uint64_t move, captured;
+    if (mem_varint(&p, end, &move) != 0 || mem_varint(&p, end, &captured) != 0)
+        return -1;
+    const uint64_t cells = (uint64_t)G->w * G->h;
+    uint64_t at = 0;
+    for (uint64_t k = 0; k < captured; ++k)
+    {
+        uint64_t v;
+        if (mem_varint(&p, end, &v) != 0)
+            return -1;
+        at += v >> 4;
+        int owner = (int)(v & 0xF);
+        if (at >= cells || owner >= (int)G->n_players)
+            return -1;
+        capture(G, at, owner);
+    }
+    for (unsigned i = 0; i < G->n_players; ++i)
+    {
+        uint64_t f[KEY_PLAYER_FIELDS];
+        for (int k = 0; k < KEY_PLAYER_FIELDS; ++k)
+            if (mem_varint(&p, end, &f[k]) != 0)
+                return -1;
+        Player *pl = &G->P[i];
+        pl->score = (unsigned)f[0];
+        pl->valids = (unsigned)f[1];
+        pl->invalids = (unsigned)f[2];
+        pl->timeouts = (unsigned)f[3];
+        pl->x = (unsigned)f[4];
+        pl->y = (unsigned)f[5];
+        pl->blocked = f[6] != 0;
+    }
+    return 0;
+}
+
+int64_t replay_seek(ReplayReader *r, uint64_t move, int use_keyframes, GameState *G)
+{
+    if (move > r->moves)
+        move = r->moves;
+
+    /* último keyframe con move <= destino */
+    uint64_t cur = 0;
+    int from_key = 0;
+    if (use_keyframes && r->count > 0 && r->index[0].move <= move)
+    {
+        unsigned lo = 0, hi = r->count - 1;
+        while (lo < hi)
+        {
+            unsigned mid = lo + (hi - lo + 1) / 2;
+            if (r->index[mid].move <= move)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        if (fseeko(r->f, (off_t)r->index[lo].offset + 1, SEEK_SET) != 0 || restore_keyframe(r, G) != 0)
+            return -1;
+        cur = r->index[lo].move;
+        from_key = 1;
+    }
+    if (!from_key)
+    {
+        if (restore_initial(r, G) != 0 || fseeko(r->f, (off_t)r->data_start, SEEK_SET) != 0)
+            return -1;
+    }
+
+    while (cur < move)
+    {
+        int c = getc(r->f);
+        if (c == EOF)
+            return -1;
+        if (c & 1)
+        {
+            unsigned p = (unsigned)c >> 4;
+            if (p >= G->n_players)
+                return -1;
+            rules_apply(G, (int)p, (Dir)((c >> 1) & 7));
+            G->P[p].blocked = !player_can_move(G, (int)p);
+            cur++;
+            continue;
+        }
+        unsigned kind = ((unsigned)c >> 1) & 3, p = (unsigned)c >> 3;
+        if (kind == REC_SPECIAL)
+        {
+            uint64_t len;
+            if (p != SPECIAL_KEYFRAME || file_varint(r->f, &len) != 0 || fseeko(r->f, (off_t)len, SEEK_CUR) != 0)
+                return -1;
+            continue;
+        }
+        if (p >= G->n_players)
+            return -1;
+        if (kind == REC_INVALID)
+        {
+            if (getc(r->f) == EOF)
+                return -1;
+            G->P[p].invalids++;
+            G->P[p].blocked = !player_can_move(G, (int)p);
+        }
+        else if (kind == REC_PASS)
+            G->P[p].blocked = true;
+        else
+            G->P[p].timeouts++;
+        cur++;
+    }
+    return (int64_t)cur;
+}
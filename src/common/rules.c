@@ -22,16 +22,15 @@ int rules_validate(const GameState *g, int pid, Dir d, int *gain) {
 
     if (x < 0 || y < 0 || x >= (int)g->w || y >= (int)g->h) return 0;
 
-    int v = g->board[idx(g, (unsigned)x, (unsigned)y)];
-
-    // chequeo que no este capturada por nadie
-    if (cell_owner(v) != -1) return 0;  // ya capturada por alguien
+    // chequeo que no este capturada por nadie (plano de ocupación, sin decodificar la celda)
+    if (occ_test(g, (unsigned)x, (unsigned)y)) return 0;
 
     // ya se que no es un player, ahora me fijo si es un valor en el rango aceptado [1,9]
-    int r = cell_reward(v);
+    int r = cell_reward(cell_get(g, idx(g, (unsigned)x, (unsigned)y)));
     if ( r > 9) return 0; 
+    if (!gain) return 1;
 
-    if (gain) *gain = r;   /* 0..9 */
+    *gain = r;   /* 0..9 */
     return 1;
 }
 
@@ -46,25 +45,44 @@ void rules_apply(GameState *g, int pid, Dir d) {
     int nx = (int)g->P[pid].x + dx;
     int ny = (int)g->P[pid].y + dy;
     /* re-leer v/r ya validados por rules_validate */
-    int v  = g->board[idx(g, (unsigned)nx, (unsigned)ny)];
+    int v  = cell_get(g, idx(g, (unsigned)nx, (unsigned)ny));
     int r  = cell_reward(v);
 
     /* mover */
-    g->P[pid].x = (unsigned short)nx;
-    g->P[pid].y = (unsigned short)ny;
+    g->P[pid].x = (unsigned)nx;
+    g->P[pid].y = (unsigned)ny;
 
     /* capturar la celda */
-    g->board[idx(g, (unsigned)nx, (unsigned)ny)] = make_captured(pid);
+    stats_on_capture(g, pid, r);
+    cell_set(g, idx(g, (unsigned)nx, (unsigned)ny), make_captured(pid));
+    occ_set(g, (unsigned)nx, (unsigned)ny);
 
     /* puntaje y contadores */
     g->P[pid].score  += (unsigned)r;
     g->P[pid].valids += 1;
 }
 
+/* 3 bits de ocupación de la fila y para x-1, x, x+1 (bit 0 = x-1); fuera del tablero cuenta como ocupado */
+static unsigned occ_row3(const GameState *g, int x, int y) {
+    if (y < 0 || y >= (int)g->h) return 7u;
+    const uint64_t *row = occ_row(g, (unsigned)y);
+    int x0 = x - 1, x1 = x + 1;
+    if (x0 >= 0 && x1 < (int)g->w && (x0 / OCC_WORD_BITS) == (x1 / OCC_WORD_BITS))
+        return (unsigned)(row[x0 / OCC_WORD_BITS] >> (x0 % OCC_WORD_BITS)) & 7u;
+    unsigned bits = 0;
+    for (int k = 0; k < 3; ++k) {
+        int xx = x0 + k;
+        if (xx < 0 || xx >= (int)g->w || ((row[xx / OCC_WORD_BITS] >> (xx % OCC_WORD_BITS)) & 1u))
+            bits |= 1u << k;
+    }
+    return bits;
+}
+
 int player_can_move(const GameState *g, int pid) {
     if (pid < 0 || (unsigned)pid >= g->n_players) return 0;
-    for (int d = 0; d < DIRECTIONS; ++d) { 
-        if (rules_validate(g, pid, (Dir)d, NULL)) return 1;
-    }
-    return 0;
+    int x = (int)g->P[pid].x, y = (int)g->P[pid].y;
+    /* vecindario 3x3 en 9 bits; la celda propia (centro, bit 4) no cuenta */
+    unsigned occ = occ_row3(g, x, y - 1) | (occ_row3(g, x, y) << 3) | (occ_row3(g, x, y + 1) << 6);
+    occ |= 1u << 4;
+    return (occ & 0x1FFu) != 0x1FFu;
 }
@@ -1,15 +1,368 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 #include "shm.h"
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <errno.h>
+#include <dirent.h>
+#include <signal.h>
 
-void *shm_create_map(const char *name, size_t size, int prot)
+#define SHM_MAP_ENV      "CHOMP_SHM_MAP"
+#define SHM_NS_ENV       "CHOMP_SHM_NS"
+#define SHM_MEMFD_PREFIX "CHOMP_MEMFD_"
+#define SHM_DIR          "/dev/shm"
+#define SHM_MAX_MAPPINGS 16
+#define SHM_MAX_MEMFDS   8
+#define SHM_MAX_OWNED    8
+#define SHM_NAME_MAX     (64 + SHM_NS_MAX)
+
+/* Flags de mapeo: -1 = todavía no leídas del entorno */
+static int map_flags = -1;
+
+/* Largo real de cada mapeo (hugetlb redondea y munmap exige el largo alineado) */
+static struct { void *addr; size_t len; } mappings[SHM_MAX_MAPPINGS];
+
+/* memfd creados por este proceso; el fd se mantiene abierto mientras viva el nombre */
+static struct { char name[SHM_NAME_MAX]; int fd; } memfds[SHM_MAX_MEMFDS];
+
+/* Namespace de la partida: -1 = todavía no leído del entorno */
+static int ns_loaded = -1;
+static char ns_buf[SHM_NS_MAX];
+
+/* nombres creados con shm_open por este proceso, para shm_remove_owned (también desde un handler) */
+static char owned[SHM_MAX_OWNED][SHM_NAME_MAX];
+
+static void track_mapping(void *p, size_t len)
+{
+    for (int i = 0; i < SHM_MAX_MAPPINGS; ++i)
+    {
+        if (mappings[i].addr == NULL)
+        {
+            mappings[i].addr = p;
+            mappings[i].len = len;
+            return;
+        }
+    }
+}
+
+/** @brief "/game_state" -> "CHOMP_MEMFD_GAME_STATE" (no alfanuméricos a '_'). */
+static void memfd_env_name(const char *name, char *out, size_t cap)
+{
+    size_t n = strlen(SHM_MEMFD_PREFIX);
+    memcpy(out, SHM_MEMFD_PREFIX, n);
+    if (*name == '/')
+        name++;
+    for (; *name && n + 1 < cap; ++name)
+        out[n++] = isalnum((unsigned char)*name) ? (char)toupper((unsigned char)*name) : '_';
+    out[n] = '\0';
+}
+
+/** @brief Tamaño de página huge por defecto (Hugepagesize de /proc/meminfo, 2 MiB si no se puede leer). */
+static size_t huge_page_size(void)
+{
+    size_t sz = 2u << 20;
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (!f)
+        return sz;
+    char line[128];
+    unsigned long kb;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1 && kb > 0)
+        {
+            sz = (size_t)kb << 10;
+            break;
+        }
+    }
+    fclose(f);
+    return sz;
+}
+
+static int ns_valid(const char *ns)
+{
+    size_t n = strlen(ns);
+    if (n == 0 || n >= SHM_NS_MAX)
+        return 0;
+    for (; *ns; ++ns)
+        if (!isalnum((unsigned char)*ns) && *ns != '-' && *ns != '_' && *ns != '.')
+            return 0;
+    return 1;
+}
+
+int shm_set_namespace(const char *ns)
+{
+    if (ns && *ns && !ns_valid(ns))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    snprintf(ns_buf, sizeof(ns_buf), "%s", ns ? ns : "");
+    ns_loaded = 1;
+    if (ns_buf[0])
+        setenv(SHM_NS_ENV, ns_buf, 1);
+    else
+        unsetenv(SHM_NS_ENV);
+    return 0;
+}
+
+const char *shm_get_namespace(void)
+{
+    if (ns_loaded < 0)
+    {
+        const char *env = getenv(SHM_NS_ENV);
+        snprintf(ns_buf, sizeof(ns_buf), "%s", env && ns_valid(env) ? env : "");
+        ns_loaded = 1;
+    }
+    return ns_buf;
+}
+
+/** @brief "/game_state" -> "/game_state.<ns>" (sin namespace, el nombre tal cual). */
+static const char *ns_name(const char *name, char *out, size_t cap)
+{
+    const char *ns = shm_get_namespace();
+    if (!ns[0])
+        return name;
+    snprintf(out, cap, "%s.%s", name, ns);
+    return out;
+}
+
+static void own_name(const char *name)
+{
+    for (int i = 0; i < SHM_MAX_OWNED; ++i)
+        if (owned[i][0] == '\0')
+        {
+            snprintf(owned[i], sizeof(owned[i]), "%s", name);
+            return;
+        }
+}
+
+static void disown_name(const char *name)
+{
+    for (int i = 0; i < SHM_MAX_OWNED; ++i)
+        if (strcmp(owned[i], name) == 0)
+            owned[i][0] = '\0';
+}
+
+void shm_remove_owned(void)
+{
+    /* sólo shm_unlink: se llama desde atexit y desde handlers de señales fatales */
+    for (int i = 0; i < SHM_MAX_OWNED; ++i)
+        if (owned[i][0] != '\0')
+        {
+            (void)shm_unlink(owned[i]);
+            owned[i][0] = '\0';
+        }
+}
+
+/** @brief pid del namespace de una entrada de /dev/shm ("game_state.tag.1234" -> 1234), 0 si no tiene. */
+static long entry_pid(const char *entry)
+{
+    const char *dot = strrchr(entry, '.');
+    if (!dot || !dot[1])
+        return 0;
+    char *end;
+    long pid = strtol(dot + 1, &end, 10);
+    return *end == '\0' && pid > 0 ? pid : 0;
+}
+
+/** @brief El proceso ya terminó: no existe, o es un zombie que nadie esperó todavía. */
+static int pid_gone(long pid)
 {
+    if (kill((pid_t)pid, 0) != 0)
+        return errno == ESRCH;
+    char path[32], buf[64];
+    snprintf(path, sizeof(path), "/proc/%ld/stat", pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return 0;
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    /* "pid (comm) S ...": el estado va después del último ')' */
+    const char *rp = strrchr(buf, ')');
+    return rp && rp[1] == ' ' && rp[2] == 'Z';
+}
+
+int shm_gc_stale(const char *prefix)
+{
+    DIR *d = opendir(SHM_DIR);
+    if (!d)
+        return -1;
+    size_t plen = strlen(prefix);
+    int removed = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL)
+    {
+        if (strncmp(e->d_name, prefix, plen) != 0)
+            continue;
+        long pid = entry_pid(e->d_name);
+        /* sólo namespaces cuyo master ya no existe */
+        if (pid == 0 || !pid_gone(pid))
+            continue;
+        char path[sizeof(e->d_name) + 1];
+        snprintf(path, sizeof(path), "/%s", e->d_name);
+        if (shm_unlink(path) == 0)
+            removed++;
+    }
+    closedir(d);
+    return removed;
+}
+
+int shm_list_namespaces(const char *name, char out[][SHM_NS_MAX], int max)
+{
+    DIR *d = opendir(SHM_DIR);
+    if (!d)
+        return -1;
+    if (*name == '/')
+        name++;
+    size_t len = strlen(name);
+    int n = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL)
+    {
+        if (strncmp(e->d_name, name, len) != 0 || e->d_name[len] != '.' || !ns_valid(e->d_name + len + 1))
+            continue;
+        if (n < max)
+            snprintf(out[n], SHM_NS_MAX, "%s", e->d_name + len + 1);
+        n++;
+    }
+    closedir(d);
+    return n;
+}
+
+unsigned shm_get_map_flags(void)
+{
+    if (map_flags < 0)
+    {
+        unsigned f = 0;
+        const char *env = getenv(SHM_MAP_ENV);
+        if (env == NULL || shm_parse_map_flags(env, &f) != 0)
+            f = 0;
+        map_flags = (int)f;
+    }
+    return (unsigned)map_flags;
+}
+
+void shm_set_map_flags(unsigned flags)
+{
+    map_flags = (int)flags;
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u", flags);
+    setenv(SHM_MAP_ENV, buf, 1);
+}
+
+int shm_parse_map_flags(const char *s, unsigned *out)
+{
+    char *end;
+    unsigned long num = strtoul(s, &end, 10);
+    if (end != s && *end == '\0')
+    {
+        if (num & ~(unsigned long)(SHM_MAP_POPULATE | SHM_MAP_THP | SHM_MAP_HUGETLB))
+            return -1;
+        *out = (unsigned)num;
+        return 0;
+    }
+
+    unsigned f = 0;
+    const char *p = s;
+    while (*p)
+    {
+        size_t len = strcspn(p, ",");
+        if (len == 8 && strncmp(p, "populate", len) == 0) f |= SHM_MAP_POPULATE;
+        else if (len == 3 && strncmp(p, "thp", len) == 0) f |= SHM_MAP_THP;
+        else if (len == 7 && strncmp(p, "hugetlb", len) == 0) f |= SHM_MAP_HUGETLB;
+        else if (len == 4 && strncmp(p, "none", len) == 0) { /* sin opciones */ }
+        else return -1;
+        p += len;
+        if (*p == ',')
+            p++;
+    }
+    *out = f;
+    return 0;
+}
+
+/** @brief mmap compartido aplicando MAP_POPULATE / MADV_HUGEPAGE según flags. */
+static void *map_fd(int fd, size_t len, int prot, unsigned flags)
+{
+    int mflags = MAP_SHARED;
+    if (flags & SHM_MAP_POPULATE)
+        mflags |= MAP_POPULATE;
+    void *p = mmap(NULL, len, prot, mflags, fd, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+    /* THP es sólo un consejo: si shmem_enabled no lo permite seguimos con páginas normales */
+    if (flags & SHM_MAP_THP)
+        (void)madvise(p, len, MADV_HUGEPAGE);
+    track_mapping(p, len);
+    return p;
+}
+
+/**
+ * @brief Intenta crear el segmento sobre un memfd hugetlb.
+ * @return mapeo o NULL si no hay páginas huge disponibles (el llamador cae a shm_open).
+ */
+static void *create_hugetlb(const char *name, size_t size, int prot, unsigned flags)
+{
+    int slot = -1;
+    for (int i = 0; i < SHM_MAX_MEMFDS; ++i)
+        if (memfds[i].name[0] == '\0') { slot = i; break; }
+    if (slot < 0 || strlen(name) >= sizeof(memfds[0].name))
+        return NULL;
+
+    int fd = memfd_create(name, MFD_HUGETLB | MFD_CLOEXEC);
+    if (fd == -1)
+        return NULL;
+    size_t hp = huge_page_size();
+    size_t len = (size + hp - 1) / hp * hp;
+    /* fallocate falla acá (ENOSPC/ENOMEM) si no alcanzan las páginas reservadas */
+    if (ftruncate(fd, (off_t)len) == -1 || posix_fallocate(fd, 0, (off_t)len) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+    void *p = map_fd(fd, len, prot, flags & ~SHM_MAP_THP);
+    if (p == NULL)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    char env[SHM_NAME_MAX + 16], val[32];
+    memfd_env_name(name, env, sizeof(env));
+    snprintf(val, sizeof(val), "%ld:%d", (long)getpid(), fd);
+    setenv(env, val, 1);
+    snprintf(memfds[slot].name, sizeof(memfds[slot].name), "%s", name);
+    memfds[slot].fd = fd;
+    return p;
+}
+
+void *shm_create_map(const char *base, size_t size, int prot)
+{
+    char full[SHM_NAME_MAX];
+    const char *name = ns_name(base, full, sizeof(full));
+    if (size > (size_t)INTPTR_MAX)
+    {
+        errno = EOVERFLOW;
+        perror("shm_create_map size");
+        return NULL;
+    }
+    unsigned flags = shm_get_map_flags();
+    if (flags & SHM_MAP_HUGETLB)
+    {
+        void *p = create_hugetlb(name, size, prot, flags);
+        if (p != NULL)
+            return p;
+        fprintf(stderr, "shm %s: hugetlb no disponible, usando páginas normales\n", name);
+    }
+
     int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
     if (fd == -1)
     {
@@ -20,24 +373,58 @@ void *shm_create_map(const char *name, size_t size, int prot)
     {
         perror("ftruncate");
         close(fd);
+        shm_unlink(name);
         return NULL;
     }
-    void *p = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
-    if (p == MAP_FAILED)
+    /* Reservar el respaldo ahora: sin esto un tmpfs lleno se descubre con SIGBUS al escribir */
+    int err = posix_fallocate(fd, 0, (off_t)size);
+    if (err != 0)
+    {
+        errno = err;
+        perror("posix_fallocate");
+        close(fd);
+        shm_unlink(name);
+        errno = err;
+        return NULL;
+    }
+    void *p = map_fd(fd, size, prot, flags);
+    if (p == NULL)
     {
         perror("mmap create");
         close(fd);
         return NULL;
     }
     close(fd);
+    own_name(name);
     return p;
 }
 
-void *shm_attach_map(const char *name, size_t *out_size, int prot)
+/** @brief Abre el segmento: memfd publicado por el creador (pid:fd) o, si no hay, shm_open. */
+static int open_segment(const char *name, int oflags)
+{
+    char env[SHM_NAME_MAX + 16];
+    memfd_env_name(name, env, sizeof(env));
+    const char *val = getenv(env);
+    long pid;
+    int mfd;
+    if (val != NULL && sscanf(val, "%ld:%d", &pid, &mfd) == 2)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%ld/fd/%d", pid, mfd);
+        int fd = open(path, oflags);
+        if (fd != -1)
+            return fd;
+    }
+    return shm_open(name, oflags, 0600);
+}
+
+void *shm_attach_map(const char *base, size_t *out_size, int prot)
 {
+    char full[SHM_NAME_MAX];
+    const char *name = ns_name(base, full, sizeof(full));
     /* Si el mapeo requiere escritura debemos abrir con O_RDWR o mmap fallará con EACCES */
     int oflags = (prot & PROT_WRITE) ? O_RDWR : O_RDONLY;
-    int fd = shm_open(name, oflags, 0600);
+    int fd = open_segment(name, oflags);
     if (fd == -1)
     {
         perror("shm_open attach");
@@ -50,8 +437,8 @@ void *shm_attach_map(const char *name, size_t *out_size, int prot)
         close(fd);
         return NULL;
     }
-    void *p = mmap(NULL, (size_t)st.st_size, prot, MAP_SHARED, fd, 0);
-    if (p == MAP_FAILED)
+    void *p = map_fd(fd, (size_t)st.st_size, prot, shm_get_map_flags());
+    if (p == NULL)
     {
         perror("mmap attach");
         close(fd);
@@ -63,7 +450,36 @@ void *shm_attach_map(const char *name, size_t *out_size, int prot)
     return p;
 }
 
-int shm_remove_name(const char *name)
+int shm_unmap(void *p, size_t size)
 {
+    for (int i = 0; i < SHM_MAX_MAPPINGS; ++i)
+    {
+        if (mappings[i].addr == p)
+        {
+            size = mappings[i].len;
+            mappings[i].addr = NULL;
+            break;
+        }
+    }
+    return munmap(p, size);
+}
+
+int shm_remove_name(const char *base)
+{
+    char full[SHM_NAME_MAX];
+    const char *name = ns_name(base, full, sizeof(full));
+    for (int i = 0; i < SHM_MAX_MEMFDS; ++i)
+    {
+        if (memfds[i].name[0] != '\0' && strcmp(memfds[i].name, name) == 0)
+        {
+            char env[SHM_NAME_MAX + 16];
+            memfd_env_name(name, env, sizeof(env));
+            unsetenv(env);
+            close(memfds[i].fd);
+            memfds[i].name[0] = '\0';
+            return 0;
+        }
+    }
+    disown_name(name);
     return shm_unlink(name);
 }
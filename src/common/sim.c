@@ -0,0 +1,96 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "sim.h"
+#include "rules.h"
+#include <errno.h>
+
+#define PASS_SENTINEL 0xFF
+
+int sim_init(SimGame *s, unsigned w, unsigned h, unsigned n_players, CellFormat fmt)
+{
+    if (!s || w == 0 || h == 0 || n_players == 0 || n_players > MAX_PLAYERS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    s->G = state_alloc(w, h, fmt);
+    if (!s->G)
+        return -1;
+    s->w = w;
+    s->h = h;
+    s->n_players = n_players;
+    s->max_rounds = SIM_MAX_ROUNDS;
+    s->rounds = 0;
+    s->replay = NULL;
+    return 0;
+}
+
+void sim_reset(SimGame *s, unsigned seed)
+{
+    state_zero(s->G, s->w, s->h, s->n_players);
+    board_fill_rewards(s->G, seed);
+    players_place_grid(s->G);
+    for (unsigned i = 0; i < s->n_players; ++i)
+        s->G->P[i].blocked = !player_can_move(s->G, (int)i);
+    s->rounds = 0;
+}
+
+static int all_blocked(const GameState *G)
+{
+    for (unsigned i = 0; i < G->n_players; ++i)
+        if (!G->P[i].blocked)
+            return 0;
+    return 1;
+}
+
+/* un turno del jugador i: misma semántica que el master para PASS/VALID/INVALID */
+static void sim_turn(GameState *G, int i, const SimPolicy *p, ReplayWriter *rw)
+{
+    uint8_t mv = PASS_SENTINEL;
+    if (!p->choose(G, i, p->ctx, &mv))
+        mv = PASS_SENTINEL;
+
+    if (mv == PASS_SENTINEL)
+    {
+        G->P[i].blocked = true;
+        replay_record(rw, G, (unsigned)i, REPLAY_PASS, mv);
+        return;
+    }
+    int ok = mv < 8 && rules_validate(G, i, (Dir)mv, NULL);
+    if (ok)
+        rules_apply(G, i, (Dir)mv);
+    else
+        G->P[i].invalids++;
+    G->P[i].blocked = !player_can_move(G, i);
+    replay_record(rw, G, (unsigned)i, ok ? REPLAY_VALID : REPLAY_INVALID, mv);
+}
+
+unsigned sim_run(SimGame *s, const SimPolicy *policies)
+{
+    GameState *G = s->G;
+    unsigned n = s->n_players;
+
+    /* mismo criterio de corte que el loop del master */
+    while (!all_blocked(G))
+    {
+        for (unsigned i = 0; i < n; ++i)
+        {
+            if (!G->P[i].blocked)
+                sim_turn(G, (int)i, &policies[i], s->replay);
+        }
+        if (all_blocked(G))
+            break;
+        if (++s->rounds >= s->max_rounds)
+            break;
+    }
+    G->game_over = true;
+    return s->rounds;
+}
+
+void sim_free(SimGame *s)
+{
+    if (!s)
+        return;
+    free(s->G);
+    s->G = NULL;
+}
@@ -1,21 +1,50 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
 #include "state.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
-// Constantes para la disposición de jugadores en grilla
-#define GRID_SIZE 3        // Tamaño de la grilla (3x3)
-#define GRID_DIVISIONS 6   // Divisiones del tablero para posicionar jugadores
-#define FIRST_THIRD 1      // Primera posición (1/6 del tablero)
-#define MIDDLE_THIRD 3     // Posición central (3/6 del tablero)
-#define LAST_THIRD 5       // Última posición (5/6 del tablero)
+// Generación del tablero
+#define FILL_THREADS_ENV "CHOMP_FILL_THREADS"
+#define FILL_MT_MIN_CELLS (1u << 20)   // debajo de esto crear hilos cuesta más que llenar
+#define FILL_MAX_THREADS 64
+#define FILL_BLOCK_CELLS 8             // celdas por cada valor de 64 bits del generador
+#define FILL_CHUNK_BLOCKS 16           // los hilos se reparten tramos de 128 celdas (líneas de caché enteras)
+#define FILL_GOLDEN 0x9E3779B97F4A7C15ull
 
-int idx(const GameState *g, unsigned x, unsigned y) {
-    return (int)(y * g->w + x);
+size_t idx(const GameState *g, unsigned x, unsigned y) {
+    return (size_t)y * g->w + x;
 }
 
-size_t state_size(unsigned w, unsigned h) {
-    return sizeof(GameState) + (size_t)w * (size_t)h * sizeof(int);
+size_t state_size(unsigned w, unsigned h, CellFormat fmt) {
+    return sizeof(GameState) + occ_offset(w, h, fmt) + occ_bytes(w, h);
+}
+
+/* límite PTRDIFF_MAX: mmap/ftruncate usan off_t y los punteros deben poder restarse */
+#define STATE_MAX_CELLS (((size_t)PTRDIFF_MAX - sizeof(GameState)) / (sizeof(int) + 1))
+
+#if SIZE_MAX > UINT32_MAX
+/* en 64 bits cualquier tablero con lados <= STATE_MAX_SIDE entra; en 32 bits decide el chequeo */
+_Static_assert((uint64_t)STATE_MAX_SIDE * STATE_MAX_SIDE <= STATE_MAX_CELLS, "STATE_MAX_SIDE no entra en PTRDIFF_MAX");
+#endif
+
+int state_size_checked(unsigned w, unsigned h, CellFormat fmt, size_t *out_size) {
+    if (w == 0 || h == 0 || w > STATE_MAX_SIDE || h > STATE_MAX_SIDE) {
+        errno = EINVAL;
+        return -1;
+    }
+    size_t cells;
+    if (__builtin_mul_overflow((size_t)w, (size_t)h, &cells) || cells > STATE_MAX_CELLS) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (out_size) *out_size = state_size(w, h, fmt);
+    return 0;
 }
 
 void state_zero(GameState *g, unsigned w, unsigned h, unsigned n_players) {
@@ -38,77 +67,296 @@ void state_zero(GameState *g, unsigned w, unsigned h, unsigned n_players) {
     }
 
     size_t cells = (size_t)w * (size_t)h;
-    memset(g->board, 0, cells * sizeof(int));
+    memset(&g->stats, 0, sizeof(g->stats));
+    g->stats.free_cells = cells;
+    memset(g->board, 0, cells * cell_bytes(g->cell_format));
+    memset(occ_row_mut(g, 0), 0, occ_bytes(w, h));
 }
 
-void board_fill_rewards(GameState *g, unsigned seed) {
-    srand(seed);
-    size_t cells = (size_t)g->w * (size_t)g->h;
-    for (size_t i = 0; i < cells; ++i) {
-        g->board[i] = 1 + rand() % 9;
+/* finalizador de splitmix64: biyección que mezcla bien contadores consecutivos */
+static inline uint64_t fill_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* Cada hash da FILL_BLOCK_CELLS recompensas: los dígitos en base 9 de z/2^64,
+   extraídos multiplicando (sin el sesgo de '%'; desvío < 9^8/2^64). */
+static inline int fill_next(uint64_t *z) {
+    __extension__ unsigned __int128 m = (unsigned __int128)*z * 9u;
+    *z = (uint64_t)m;
+    return 1 + (int)(m >> 64);
+}
+
+typedef struct {
+    GameState *g;
+    uint64_t key;
+    size_t block0, block1;  // bloques de FILL_BLOCK_CELLS celdas [block0, block1)
+    uint64_t sum;
+} FillJob;
+
+/* El valor de cada celda depende sólo de (semilla, número de bloque, posición):
+   cualquier partición entre hilos da el mismo tablero. */
+static void fill_blocks(FillJob *job) {
+    GameState *g = job->g;
+    const size_t cells = (size_t)g->w * (size_t)g->h;
+    const uint64_t key = job->key;
+    uint64_t sum = 0;
+    size_t end = job->block1;
+    int tail = 0;
+    if (end * FILL_BLOCK_CELLS > cells) {   // último bloque incompleto
+        end--;
+        tail = 1;
     }
+    if (g->cell_format == CELL_FMT_BYTE) {
+        int8_t *b = (int8_t *)(void *)g->board + job->block0 * FILL_BLOCK_CELLS;
+        for (size_t k = job->block0; k < end; ++k) {
+            uint64_t z = fill_mix(key + k * FILL_GOLDEN);
+            for (int j = 0; j < FILL_BLOCK_CELLS; ++j) {
+                int r = fill_next(&z);
+                *b++ = (int8_t)r;
+                sum += (uint64_t)r;
+            }
+        }
+    } else {
+        int *b = g->board + job->block0 * FILL_BLOCK_CELLS;
+        for (size_t k = job->block0; k < end; ++k) {
+            uint64_t z = fill_mix(key + k * FILL_GOLDEN);
+            for (int j = 0; j < FILL_BLOCK_CELLS; ++j) {
+                int r = fill_next(&z);
+                *b++ = r;
+                sum += (uint64_t)r;
+            }
+        }
+    }
+    if (tail) {
+        uint64_t z = fill_mix(key + end * FILL_GOLDEN);
+        for (size_t i = end * FILL_BLOCK_CELLS; i < cells; ++i) {
+            int r = fill_next(&z);
+            cell_set(g, i, r);
+            sum += (uint64_t)r;
+        }
+    }
+    job->sum = sum;
 }
 
-static inline int in_bounds(const GameState *g, int x, int y) {
-    return (x >= 0 && y >= 0 && x < g->w && y < g->h);
+static void *fill_thread(void *arg) {
+    fill_blocks((FillJob *)arg);
+    return NULL;
 }
 
-static inline int cell_is_free_for_spawn(const GameState *g, int x, int y) {
-    int v = g->board[idx(g, (unsigned)x, (unsigned)y)];
-    return cell_owner(v) == -1;
+static unsigned fill_default_threads(size_t cells) {
+    if (cells < FILL_MT_MIN_CELLS)
+        return 1;
+    const char *env = getenv(FILL_THREADS_ENV);
+    long n = env ? strtol(env, NULL, 10) : 0;
+    if (n <= 0) {
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            n = CPU_COUNT(&set);
+        if (n <= 0)
+            n = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    return n > 0 ? (unsigned)n : 1;
 }
 
-static void find_nearest_free(const GameState *g, int x0, int y0, int *outx, int *outy) {
-    int maxr = (g->w > g->h ? g->w : g->h);
-    for (int r = 0; r <= maxr; ++r) {
-        for (int yy = y0 - r; yy <= y0 + r; ++yy) {
-            for (int xx = x0 - r; xx <= x0 + r; ++xx) {
-                if (!in_bounds(g, xx, yy)) continue;
-                if (cell_is_free_for_spawn(g, xx, yy)) {
-                    *outx = xx; *outy = yy;
-                    return;
+void board_fill_rewards_threads(GameState *g, unsigned seed, unsigned threads) {
+    const size_t cells = (size_t)g->w * (size_t)g->h;
+    const size_t blocks = (cells + FILL_BLOCK_CELLS - 1) / FILL_BLOCK_CELLS;
+    const size_t chunks = (blocks + FILL_CHUNK_BLOCKS - 1) / FILL_CHUNK_BLOCKS;
+    if (threads == 0)
+        threads = 1;
+    if (threads > FILL_MAX_THREADS)
+        threads = FILL_MAX_THREADS;
+    if (threads > chunks)
+        threads = chunks > 0 ? (unsigned)chunks : 1;
+
+    const uint64_t key = fill_mix((uint64_t)seed ^ FILL_GOLDEN);
+    FillJob jobs[FILL_MAX_THREADS];
+    pthread_t tids[FILL_MAX_THREADS];
+    int started[FILL_MAX_THREADS] = {0};
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t c0 = chunks * t / threads, c1 = chunks * (t + 1) / threads;
+        jobs[t] = (FillJob){g, key, c0 * FILL_CHUNK_BLOCKS, c1 * FILL_CHUNK_BLOCKS, 0};
+        if (jobs[t].block1 > blocks)
+            jobs[t].block1 = blocks;
+        /* el hilo actual hace el primer tramo; si un hilo no arranca, su tramo también */
+        if (t > 0)
+            started[t] = pthread_create(&tids[t], NULL, fill_thread, &jobs[t]) == 0;
+    }
+    fill_blocks(&jobs[0]);
+    uint64_t sum = jobs[0].sum;
+    for (unsigned t = 1; t < threads; ++t) {
+        if (started[t])
+            pthread_join(tids[t], NULL);
+        else
+            fill_blocks(&jobs[t]);
+        sum += jobs[t].sum;
+    }
+    g->stats.reward_cells = cells;
+    g->stats.reward_sum = sum;
+}
+
+void board_fill_rewards(GameState *g, unsigned seed) {
+    board_fill_rewards_threads(g, seed, fill_default_threads((size_t)g->w * (size_t)g->h));
+}
+
+static inline int cell_is_free_for_spawn(const GameState *g, unsigned x, unsigned y) {
+    return !occ_test(g, x, y);
+}
+
+/* Lado del lattice: la menor cantidad de columnas c con c/filas ~ w/h, o sea c*c*h >= n*w. */
+static unsigned lattice_cols(unsigned w, unsigned h, unsigned n) {
+    const uint64_t need = (uint64_t)n * w;
+    unsigned c = 1;
+    while (c < n && (uint64_t)c * c * h < need)
+        ++c;
+    return c;
+}
+
+void placement_lattice(unsigned w, unsigned h, unsigned n, unsigned *xs, unsigned *ys) {
+    if (n == 0)
+        return;
+    unsigned cols = lattice_cols(w, h, n);
+    unsigned rows = (n + cols - 1) / cols;
+    cols = (n + rows - 1) / rows;   // sin columnas de más (ej. n=3: 2x2 -> 2 filas de 2 y 1)
+    for (unsigned i = 0; i < n; ++i) {
+        unsigned row = i / cols, col = i % cols;
+        /* la última fila puede estar incompleta: sus jugadores se reparten en todo el ancho */
+        unsigned in_row = row + 1 < rows ? cols : n - row * cols;
+        /* centro de la celda (col, row) del lattice; con 3x3 es 1/6, 3/6 y 5/6 del tablero */
+        xs[i] = (unsigned)(((uint64_t)2 * col + 1) * w / (2 * (uint64_t)in_row));
+        ys[i] = (unsigned)(((uint64_t)2 * row + 1) * h / (2 * (uint64_t)rows));
+    }
+}
+
+/* primera columna libre de la fila y en [x_lo, x_hi], de a 64 celdas por palabra; -1 si no hay */
+static long row_first_free(const GameState *g, unsigned y, unsigned x_lo, unsigned x_hi) {
+    const uint64_t *row = occ_row(g, y);
+    for (unsigned wi = x_lo / OCC_WORD_BITS; wi <= x_hi / OCC_WORD_BITS; ++wi) {
+        uint64_t free_bits = ~row[wi];
+        if (wi == x_lo / OCC_WORD_BITS)
+            free_bits &= ~0ull << (x_lo % OCC_WORD_BITS);
+        if (wi == x_hi / OCC_WORD_BITS && x_hi % OCC_WORD_BITS != OCC_WORD_BITS - 1)
+            free_bits &= (1ull << (x_hi % OCC_WORD_BITS + 1)) - 1;
+        if (free_bits)
+            return (long)wi * OCC_WORD_BITS + __builtin_ctzll(free_bits);
+    }
+    return -1;
+}
+
+int placement_nearest_free(const GameState *g, unsigned x0, unsigned y0, unsigned *out_x, unsigned *out_y) {
+    const long W = (long)g->w, H = (long)g->h, cx = (long)x0, cy = (long)y0;
+    const long maxr = W > H ? W : H;
+    for (long r = 0; r <= maxr; ++r) {
+        /* sólo el anillo a distancia r (las celdas más cercanas ya se miraron), en orden de filas */
+        long y_lo = cy - r < 0 ? 0 : cy - r, y_hi = cy + r >= H ? H - 1 : cy + r;
+        long x_lo = cx - r < 0 ? 0 : cx - r, x_hi = cx + r >= W ? W - 1 : cx + r;
+        for (long y = y_lo; y <= y_hi; ++y) {
+            int edge_row = y == cy - r || y == cy + r;
+            if (edge_row) {
+                long x = row_first_free(g, (unsigned)y, (unsigned)x_lo, (unsigned)x_hi);
+                if (x >= 0) {
+                    *out_x = (unsigned)x;
+                    *out_y = (unsigned)y;
+                    return 0;
                 }
+                continue;
+            }
+            if (cx - r >= 0 && cell_is_free_for_spawn(g, (unsigned)(cx - r), (unsigned)y)) {
+                *out_x = (unsigned)(cx - r);
+                *out_y = (unsigned)y;
+                return 0;
+            }
+            if (r > 0 && cx + r < W && cell_is_free_for_spawn(g, (unsigned)(cx + r), (unsigned)y)) {
+                *out_x = (unsigned)(cx + r);
+                *out_y = (unsigned)y;
+                return 0;
             }
         }
     }
-    *outx = x0; *outy = y0;
+    return -1;
 }
 
 void players_place_grid(GameState *g) {
-    int xs[3] = { (g->w * FIRST_THIRD) / GRID_DIVISIONS, (g->w * MIDDLE_THIRD) / GRID_DIVISIONS, (g->w * LAST_THIRD) / GRID_DIVISIONS };
-    int ys[3] = { (g->h * FIRST_THIRD) / GRID_DIVISIONS, (g->h * MIDDLE_THIRD) / GRID_DIVISIONS, (g->h * LAST_THIRD) / GRID_DIVISIONS };
-
-    for (int i = 0; i < 3; ++i) {
-        if (xs[i] < 0) xs[i] = 0;
-        if (ys[i] < 0) ys[i] = 0;
-        if (xs[i] >= g->w) xs[i] = g->w - 1;
-        if (ys[i] >= g->h) ys[i] = g->h - 1;
-    }
-
     unsigned np = g->n_players;
     if (np > MAX_PLAYERS) np = MAX_PLAYERS;
+    unsigned xs[MAX_PLAYERS], ys[MAX_PLAYERS];
+    placement_lattice(g->w, g->h, np, xs, ys);
 
     for (unsigned i = 0; i < np; ++i) {
-        int row = (int)(i / 3);
-        int col = (int)(i % 3);
-        int tx = xs[col];
-        int ty = ys[row];
-
-        int px = tx, py = ty;
-        if (!cell_is_free_for_spawn(g, px, py)) {
-            find_nearest_free(g, tx, ty, &px, &py);
+        unsigned px = xs[i], py = ys[i];
+        if (!cell_is_free_for_spawn(g, px, py) && placement_nearest_free(g, xs[i], ys[i], &px, &py) != 0) {
+            px = xs[i];
+            py = ys[i];
         }
 
-        g->P[i].x = (unsigned short)px;
-        g->P[i].y = (unsigned short)py;
+        g->P[i].x = px;
+        g->P[i].y = py;
         g->P[i].blocked = false;
-        g->board[idx(g, px, py)] = make_captured((int)i);
+        stats_on_capture(g, (int)i, cell_reward(cell_get(g, idx(g, px, py))));
+        cell_set(g, idx(g, px, py), make_captured((int)i));
+        occ_set(g, px, py);
     }
 }
 
-GameState* state_create(unsigned w, unsigned h) {
-    size_t size = state_size(w, h);
-    return (GameState*)shm_create_map(SHM_GAME_STATE, size, PROT_READ | PROT_WRITE);
+GameState* state_create(unsigned w, unsigned h, CellFormat fmt) {
+    size_t size;
+    if (state_size_checked(w, h, fmt, &size) != 0) return NULL;
+    GameState *g = (GameState*)shm_create_map(SHM_GAME_STATE, size, PROT_READ | PROT_WRITE);
+    if (g) {
+        /* el formato va en el header: los que hagan attach lo leen de ahí */
+        g->w = w;
+        g->h = h;
+        g->cell_format = fmt;
+    }
+    return g;
+}
+
+GameState* state_alloc(unsigned w, unsigned h, CellFormat fmt) {
+    size_t size;
+    if (state_size_checked(w, h, fmt, &size) != 0) return NULL;
+    GameState *g = malloc(size);
+    if (g) {
+        g->w = w;
+        g->h = h;
+        g->cell_format = fmt;
+    }
+    return g;
+}
+
+int state_sync_copy(GameState *dst, const GameState *src) {
+    if (dst->w != src->w || dst->h != src->h || dst->cell_format != src->cell_format) {
+        errno = EINVAL;   /* dst no tiene lugar para src */
+        return -1;
+    }
+    int full = dst->n_players != src->n_players || src->n_players > MAX_PLAYERS;
+    uint64_t cells = 0, reward = 0;
+    for (unsigned k = 0; k < src->n_players && !full; k++) {
+        const Player *p = &src->P[k];
+        unsigned dv = p->valids - dst->P[k].valids;
+        if (dv == 0) continue;
+        if (dv != 1 || p->x >= src->w || p->y >= src->h) { full = 1; break; }
+        cells++;
+        reward += (uint64_t)cell_reward(cell_get(dst, idx(dst, p->x, p->y)));
+    }
+    /* lo que dst perdería con esas capturas debe coincidir con los agregados de src */
+    if (!full && (dst->stats.free_cells - cells != src->stats.free_cells ||
+                  dst->stats.reward_sum - reward != src->stats.reward_sum))
+        full = 1;
+    if (full) {
+        memcpy(dst, src, state_size(src->w, src->h, (CellFormat)src->cell_format));
+        return 1;
+    }
+    for (unsigned k = 0; k < src->n_players; k++) {
+        const Player *p = &src->P[k];
+        if (p->valids == dst->P[k].valids) continue;
+        size_t i = idx(src, p->x, p->y);
+        cell_set(dst, i, cell_get(src, i));
+        if (occ_test(src, p->x, p->y)) occ_set(dst, p->x, p->y);
+    }
+    memcpy(dst, src, sizeof(GameState));   /* header: jugadores, stats y game_over */
+    return 0;
 }
 
 GameState* state_attach(void) {
@@ -117,6 +365,6 @@ GameState* state_attach(void) {
 
 void state_destroy(GameState *g) {
     if (g == NULL) return;
-    size_t size = state_size(g->w, g->h);
-    munmap(g, size);
+    size_t size = state_size(g->w, g->h, (CellFormat)g->cell_format);
+    shm_unmap(g, size);
 }
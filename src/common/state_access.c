@@ -7,12 +7,11 @@ unsigned state_get_h(const GameState *G) { return G->h; }
 unsigned state_get_n(const GameState *G) { return G->n_players; }
 bool state_is_over(const GameState *G) { return G->game_over; }
 
-int state_remaining_rewards(const GameState *G)
+uint64_t state_remaining_rewards(const GameState *G) { return G->stats.reward_cells; }
+uint64_t state_remaining_reward_sum(const GameState *G) { return G->stats.reward_sum; }
+uint64_t state_free_cells(const GameState *G) { return G->stats.free_cells; }
+
+uint64_t state_captured_cells(const GameState *G, unsigned i)
 {
-    int cnt = 0;
-    for (unsigned y = 0; y < G->h; ++y)
-        for (unsigned x = 0; x < G->w; ++x)
-            if (cell_reward(G->board[idx(G, x, y)]) > 0)
-                cnt++;
-    return cnt;
+    return i < MAX_PLAYERS ? G->stats.captured[i] : 0;
 }
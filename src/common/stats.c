@@ -0,0 +1,106 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include "stats.h"
+#include "shm.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+StatsShm *stats_create(const GameState *G)
+{
+    StatsShm *s = shm_create_map(SHM_GAME_STATS, sizeof(StatsShm), PROT_READ | PROT_WRITE);
+    if (!s)
+        return NULL;
+    /* un segmento con el mismo nombre de una partida anterior conserva sus datos */
+    memset(s, 0, sizeof(*s));
+    s->version = STATS_VERSION;
+    s->n_players = G->n_players;
+    for (unsigned i = 0; i < G->n_players && i < MAX_PLAYERS; ++i)
+        memcpy(s->names[i], G->P[i].name, NAME_LEN);
+    atomic_init(&s->rounds, 0);
+    atomic_init(&s->game_over, 0);
+    /* magic al final: chompstat no acepta un segmento a medio inicializar */
+    atomic_thread_fence(memory_order_release);
+    memcpy(s->magic, STATS_MAGIC, sizeof(s->magic));
+    return s;
+}
+
+void stats_destroy(StatsShm *s)
+{
+    if (!s)
+        return;
+    /* quien ya lo tenga mapeado sigue viendo el final de la partida */
+    atomic_store_explicit(&s->game_over, 1, memory_order_release);
+    shm_unmap(s, sizeof(*s));
+    shm_remove_name(SHM_GAME_STATS);
+}
+
+const StatsShm *stats_attach(void)
+{
+    size_t size = 0;
+    StatsShm *s = shm_attach_map(SHM_GAME_STATS, &size, PROT_READ);
+    if (!s)
+        return NULL;
+    if (size < sizeof(*s) || memcmp(s->magic, STATS_MAGIC, sizeof(s->magic)) != 0 || s->version != STATS_VERSION)
+    {
+        shm_unmap(s, size);
+        errno = EINVAL;
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return s;
+}
+
+void stats_detach(const StatsShm *s)
+{
+    if (s)
+        shm_unmap((void *)(uintptr_t)s, sizeof(*s));
+}
+
+void stats_snapshot(const StatsHist *h, StatsSnapshot *out)
+{
+    out->count = 0;
+    for (unsigned b = 0; b < STATS_BUCKETS; ++b)
+    {
+        out->bucket[b] = atomic_load_explicit(&h->bucket[b], memory_order_relaxed);
+        out->count += out->bucket[b];
+    }
+    out->sum_ns = atomic_load_explicit(&h->sum_ns, memory_order_relaxed);
+    out->max_ns = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+}
+
+/* mayor valor que cae en el bucket b */
+static uint64_t bucket_high(unsigned b)
+{
+    if (b < STATS_SUB)
+        return b;
+    unsigned shift = b / STATS_SUB - 1;
+    uint64_t low = (uint64_t)(STATS_SUB + b % STATS_SUB) << shift;
+    return low + ((uint64_t)1 << shift) - 1;
+}
+
+uint64_t stats_percentile(const StatsSnapshot *s, double q)
+{
+    if (s->count == 0)
+        return 0;
+    if (q < 0.0)
+        q = 0.0;
+    if (q > 1.0)
+        q = 1.0;
+    uint64_t rank = (uint64_t)(q * (double)s->count + 0.5);
+    if (rank == 0)
+        rank = 1;
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < STATS_BUCKETS; ++b)
+    {
+        seen += s->bucket[b];
+        if (seen >= rank)
+        {
+            uint64_t v = bucket_high(b);
+            /* el máximo exacto acota el último bucket */
+            return s->max_ns && v > s->max_ns ? s->max_ns : v;
+        }
+    }
+    return s->max_ns;
+}
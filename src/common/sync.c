@@ -9,12 +9,13 @@
 #include <string.h>
 #include <stdio.h>
 #include "shm.h"
+#include "futex.h"
 #include <time.h>
 #include <errno.h>
+#include <limits.h>
+#include <sched.h>
 
-#define MILLISEC_PER_SEC 1000
-#define NANOSEC_PER_MILLISEC 1000000L
-#define NANOSEC_PER_SEC 1000000000L
+#define MOVE_RING_SPIN 4096     /* lecturas de head antes de dormir en el futex */
 
 static SyncMem *S = NULL;
 
@@ -52,15 +53,19 @@ int sync_create(void)
     }
 
     S->readers_count = 0;
+    atomic_init(&S->state_seq, 0);
 
+    atomic_init(&S->broadcast_epoch, 0);
     for (int i = 0; i < MAX_PLAYERS; i++)
     {
-        if (sem_init(&S->player_turns[i], 1, 0) == -1)
-        {
-            perror("sem_init player_turns");
-            return -1;
-        }
+        atomic_init(&S->player_turns[i].wake, 0);
+        atomic_init(&S->player_turns[i].grants, 0);
+        atomic_init(&S->rings[i].head, 0);
+        atomic_init(&S->rings[i].sleeping, 0);
+        atomic_init(&S->rings[i].tail, 0);
     }
+    atomic_init(&S->move_rings, 0);
+    atomic_init(&S->view_frames, 0);
 
     return 0;
 }
@@ -82,12 +87,7 @@ void sync_destroy(void)
     sem_destroy(&S->state_mutex);
     sem_destroy(&S->readers_count_mutex);
 
-    for (int i = 0; i < MAX_PLAYERS; i++)
-    {
-        sem_destroy(&S->player_turns[i]);
-    }
-
-    munmap(S, sizeof(SyncMem));
+    shm_unmap(S, sizeof(SyncMem));
     shm_remove_name(SHM_GAME_SYNC);
     S = NULL;
 }
@@ -129,16 +129,37 @@ void wrlock(void)
     sem_wait(&S->writer_mutex);
     // Esperamos a que los lectores actuales terminen y bloqueamos para escritura exclusiva.
     sem_wait(&S->state_mutex);
+    // Secuencia impar: los lectores optimistas descartan lo que lean a partir de acá.
+    unsigned seq = atomic_load_explicit(&S->state_seq, memory_order_relaxed);
+    atomic_store_explicit(&S->state_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
 }
 
 void wrunlock(void)
 {
+    // Secuencia par de nuevo: publica las escrituras a los lectores optimistas.
+    atomic_fetch_add_explicit(&S->state_seq, 1, memory_order_release);
     // Liberamos el bloqueo de escritura.
     sem_post(&S->state_mutex);
     // Abrimos el torniquete para que los lectores puedan volver a entrar.
     sem_post(&S->writer_mutex);
 }
 
+unsigned seq_read_begin(void)
+{
+    unsigned seq;
+    // Con escritura en curso (impar) cedemos el CPU hasta que el master termine.
+    while ((seq = atomic_load_explicit(&S->state_seq, memory_order_acquire)) & 1u)
+        sched_yield();
+    return seq;
+}
+
+int seq_read_retry(unsigned seq)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&S->state_seq, memory_order_relaxed) != seq;
+}
+
 void view_signal_update_ready(void)
 {
     sem_post(&S->view_update_ready);
@@ -159,36 +180,215 @@ void view_wait_render_complete(void)
     sem_wait(&S->view_render_complete);
 }
 
+int view_wait_render_complete_timed(int timeout_ms)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    int r;
+    while ((r = sem_timedwait(&S->view_render_complete, &ts)) == -1 && errno == EINTR)
+        ;
+    return r;
+}
+
+void sync_enable_view_frames(void)
+{
+    atomic_store_explicit(&S->view_frames, 1, memory_order_release);
+}
+
+int sync_view_frames_enabled(void)
+{
+    return atomic_load_explicit(&S->view_frames, memory_order_acquire) != 0;
+}
+
 void player_signal_turn(int i)
 {
-    if (i >= 0 && i < MAX_PLAYERS)
-        sem_post(&S->player_turns[i]);
+    if (i < 0 || i >= MAX_PLAYERS)
+        return;
+    TurnSlot *t = &S->player_turns[i];
+    atomic_fetch_add_explicit(&t->grants, 1, memory_order_release);
+    atomic_fetch_add_explicit(&t->wake, 1, memory_order_release);
+    futex_wake(&t->wake, 1);
+}
+
+/* consume un turno pendiente si lo hay (solo el jugador i decrementa) */
+static int take_turn(TurnSlot *t)
+{
+    unsigned g = atomic_load_explicit(&t->grants, memory_order_acquire);
+    while (g > 0)
+    {
+        if (atomic_compare_exchange_weak_explicit(&t->grants, &g, g - 1,
+                                                  memory_order_acquire, memory_order_acquire))
+            return 1;
+    }
+    return 0;
+}
+
+/* núcleo de las esperas de turno: deadline NULL = sin timeout, epoch NULL = ignorar broadcasts */
+static int wait_turn(int i, const struct timespec *deadline, unsigned *epoch)
+{
+    if (i < 0 || i >= MAX_PLAYERS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    TurnSlot *t = &S->player_turns[i];
+    for (;;)
+    {
+        // Leer la palabra antes de chequear: si el master la cambia después, futex_wait no duerme.
+        unsigned w = atomic_load_explicit(&t->wake, memory_order_acquire);
+        if (take_turn(t))
+            return 1;
+        if (epoch)
+        {
+            unsigned e = atomic_load_explicit(&S->broadcast_epoch, memory_order_acquire);
+            if (e != *epoch)
+            {
+                *epoch = e;
+                return 0;
+            }
+        }
+        if (futex_wait(&t->wake, w, deadline) == -1)
+        {
+            if (errno == ETIMEDOUT)
+                return 0;
+            if (errno != EINTR)
+                return -1;
+        }
+    }
 }
 
 void player_wait_turn(int i)
 {
-    if (i >= 0 && i < MAX_PLAYERS)
-        sem_wait(&S->player_turns[i]);
+    (void)wait_turn(i, NULL, NULL);
 }
 
 int player_wait_turn_timed(int i, int timeout_ms)
+{
+    if (timeout_ms <= 0)
+        return wait_turn(i, NULL, NULL);
+    struct timespec deadline;
+    futex_deadline_ms(&deadline, timeout_ms);
+    return wait_turn(i, &deadline, NULL);
+}
+
+int player_wait_turn_or_broadcast(int i, unsigned *epoch)
+{
+    return wait_turn(i, NULL, epoch);
+}
+
+void sync_enable_move_rings(void)
+{
+    atomic_store_explicit(&S->move_rings, 1, memory_order_release);
+}
+
+int sync_move_rings_enabled(void)
+{
+    return atomic_load_explicit(&S->move_rings, memory_order_acquire) != 0;
+}
+
+int player_send_move(int i, uint8_t mv)
 {
     if (i < 0 || i >= MAX_PLAYERS)
+    {
+        errno = EINVAL;
         return -1;
-    struct timespec ts;
-    if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
-        return -1;
-    ts.tv_sec += timeout_ms / MILLISEC_PER_SEC;
-    ts.tv_nsec += (timeout_ms % MILLISEC_PER_SEC) * NANOSEC_PER_MILLISEC;
-    if (ts.tv_nsec >= NANOSEC_PER_SEC)
+    }
+    if (!sync_move_rings_enabled())
+        return write(1, &mv, 1) == 1 ? 0 : -1;
+
+    MoveRing *r = &S->rings[i];
+    unsigned h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_acquire);
+    if (h - t >= MOVE_RING_LEN)
     {
-        ts.tv_sec += 1;
-        ts.tv_nsec -= NANOSEC_PER_SEC;
+        errno = EAGAIN;
+        return -1;
     }
-    int r = sem_timedwait(&S->player_turns[i], &ts);
-    if (r == 0)
-        return 1;
-    if (errno == ETIMEDOUT)
+    r->buf[h % MOVE_RING_LEN] = mv;
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+    // Publicar head antes de mirar 'sleeping' (el master hace lo simétrico): nunca se pierde un aviso.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&r->sleeping, memory_order_relaxed))
+        futex_wake(&r->head, 1);
+    return 0;
+}
+
+int move_ring_pop(int i, uint8_t *mv)
+{
+    MoveRing *r = &S->rings[i];
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (atomic_load_explicit(&r->head, memory_order_acquire) == t)
         return 0;
-    return -1;
-}
\ No newline at end of file
+    *mv = r->buf[t % MOVE_RING_LEN];
+    atomic_store_explicit(&r->tail, t + 1, memory_order_release);
+    return 1;
+}
+
+int move_ring_pending(int i)
+{
+    MoveRing *r = &S->rings[i];
+    return atomic_load_explicit(&r->head, memory_order_acquire) !=
+           atomic_load_explicit(&r->tail, memory_order_relaxed);
+}
+
+int move_ring_wait(int i, const struct timespec *deadline)
+{
+    static long ncpu = 0;
+    if (ncpu == 0)
+        ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    MoveRing *r = &S->rings[i];
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    // Con un solo CPU el jugador no avanza mientras esperamos activamente: directo al futex.
+    if (ncpu > 1)
+        for (int k = 0; k < MOVE_RING_SPIN; ++k)
+            if (atomic_load_explicit(&r->head, memory_order_acquire) != t)
+                return 1;
+
+    atomic_store_explicit(&r->sleeping, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    unsigned h = atomic_load_explicit(&r->head, memory_order_acquire);
+    if (h == t)
+        (void)futex_wait(&r->head, h, deadline);
+    atomic_store_explicit(&r->sleeping, 0, memory_order_relaxed);
+    return move_ring_pending(i);
+}
+
+void sync_broadcast(void)
+{
+    atomic_fetch_add_explicit(&S->broadcast_epoch, 1, memory_order_release);
+    futex_wake(&S->broadcast_epoch, INT_MAX);
+    // También cambiar la palabra de cada jugador: quienes esperan turno duermen ahí.
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        atomic_fetch_add_explicit(&S->player_turns[i].wake, 1, memory_order_release);
+        futex_wake(&S->player_turns[i].wake, INT_MAX);
+    }
+}
+
+unsigned sync_broadcast_epoch(void)
+{
+    return atomic_load_explicit(&S->broadcast_epoch, memory_order_acquire);
+}
+
+void sync_wait_broadcast(unsigned *epoch)
+{
+    for (;;)
+    {
+        unsigned e = atomic_load_explicit(&S->broadcast_epoch, memory_order_acquire);
+        if (e != *epoch)
+        {
+            *epoch = e;
+            return;
+        }
+        if (futex_wait(&S->broadcast_epoch, e, NULL) == -1 && errno != EINTR)
+            return;
+    }
+}
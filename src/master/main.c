@@ -8,13 +8,13 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
-#include <sys/select.h>
 #include <sys/wait.h>
 #include <string.h>
 #include <errno.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <time.h>
+#include <sys/prctl.h>
 
 #include "state.h"
 #include "state_access.h"
@@ -22,33 +22,95 @@
 #include "master_logic.h"
 #include "rules.h"
 #include "shm.h"
+#include "master_events.h"
+#include "evlog.h"
+#include "replay.h"
+#include "frames.h"
+#include "stats.h"
+
+#define MASTER_EVLOG_PATH_FMT "./logs/master.%s.evlog"   /* %s = namespace de las shm; decodificar con ./chomplog */
+#define LOG_PATH_MAX 128
+#define EXIT_GRACE_MS 200   /* espera a que los players terminen solos antes de SIGTERM */
+#define EXIT_POLL_MS 2
+
+#define SHM_GC_PREFIX "game_"   /* segmentos de partidas (/game_state.<ns>, /game_sync.<ns>, ...) */
+
+/* --- señales: SIGINT/SIGTERM llegan por el signalfd del loop de eventos --- */
+static int stop_flag = 0;
+static sigset_t child_sigmask; /* máscara original, restaurada en los hijos antes de exec */
+static MasterEvents *loop_ev;  /* para revisar el signalfd en las esperas fuera del loop */
+static pid_t master_pid;
+
+/* señal que termina al master sin pasar por el loop: borrar las shm y morir con la misma señal */
+static void fatal_signal(int sig)
+{
+    shm_remove_owned();
+    raise(sig);
+}
 
-/* --- señales --- */
-static volatile sig_atomic_t stop_flag = 0;
-static void on_signal(int sig)
+static void install_fatal_handlers(void)
 {
-    (void)sig;
-    stop_flag = 1;
+    static const int sigs[] = {SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL, SIGHUP, SIGQUIT};
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = fatal_signal;
+    sa.sa_flags = SA_RESETHAND;   /* el raise del handler usa la acción por defecto */
+    sigemptyset(&sa.sa_mask);
+    for (size_t i = 0; i < sizeof(sigs) / sizeof(sigs[0]); ++i)
+        sigaction(sigs[i], &sa, NULL);
 }
 
-/* --- helpers de tiempo --- */
-static long ms_since(const struct timespec *t0)
+/* namespace propio (etiqueta + pid) y limpieza de los que dejaron masters muertos */
+static int setup_shm_namespace(const char *tag)
 {
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    long ms = (now.tv_sec - t0->tv_sec) * 1000L + (now.tv_nsec - t0->tv_nsec) / 1000000L; // MAGIC NUMBER
-    return ms;
+    int gc = shm_gc_stale(SHM_GC_PREFIX);
+    if (gc > 0)
+        fprintf(stderr, "master: %d segmentos de partidas terminadas eliminados\n", gc);
+    char ns[SHM_NS_MAX];
+    if (tag && *tag)
+        snprintf(ns, sizeof(ns), "%s.%ld", tag, (long)master_pid);
+    else
+        snprintf(ns, sizeof(ns), "%ld", (long)master_pid);
+    if (shm_set_namespace(ns) != 0)
+    {
+        fprintf(stderr, "master: namespace inválido '%s' (letras, dígitos, '-', '_' o '.')\n", ns);
+        return -1;
+    }
+    /* exit() en cualquier camino de error también borra lo creado */
+    atexit(shm_remove_owned);
+    install_fatal_handlers();
+    return 0;
 }
 
-/* sleep en milisegundos */
-static void msleep_int(int ms)
+/* en el hijo, antes de exec: morir con el master aunque éste muera sin limpiar */
+static void die_with_master(void)
+{
+    (void)prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if (getppid() != master_pid)
+        _exit(1);   /* el master murió antes del prctl */
+}
+
+/* --- helpers de tiempo --- */
+
+/* sleep en milisegundos; SIGINT/SIGTERM lo cortan y levantan stop_flag (devuelve 1) */
+static int msleep_int(int ms)
 {
     if (ms <= 0)
-        return;
-    struct timespec ts;
-    ts.tv_sec = ms / 1000;
-    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
-    nanosleep(&ts, NULL);
+        return 0;
+    if (events_sleep(loop_ev, ms))
+    {
+        stop_flag = 1;
+        return 1;
+    }
+    return 0;
+}
+
+/* waitpid bloqueante que sigue atendiendo SIGINT/SIGTERM: si llegan, termina al hijo con 'sig' */
+static void reap_child(pid_t pid, int *status, int sig)
+{
+    while (waitpid(pid, status, WNOHANG) == 0)
+        if (msleep_int(EXIT_POLL_MS))
+            kill(pid, sig);
 }
 
 /* marcar un descriptor como close-on-exec para que no lo hereden futuros exec */
@@ -105,7 +167,27 @@ static void print_ranking(const GameState *G)
     printf("=====================\n");
 }
 
-static int spawn_player(const char *path, int pipefd[2], unsigned W, unsigned H)
+/* frame para la view: en modo frames se publica sin esperarla; si no, handshake por semáforos.
+   El tiempo va al histograma de render de 'row' (jugador o STATS_ROW_MASTER). */
+static void view_frame(int has_view, FrameWriter *frames, const GameState *G, StatsShm *stats, unsigned row)
+{
+    if (!has_view)
+        return;
+    uint64_t t0 = stats_now_ns();
+    if (frames)
+        (void)frames_publish(frames, G, 0);
+    else
+    {
+        view_signal_update_ready();
+        /* espera por tramos para no quedar sordo a SIGINT/SIGTERM si la view no responde */
+        while (!stop_flag && view_wait_render_complete_timed(RING_POLL_MS) != 0 && errno == ETIMEDOUT)
+            if (events_sleep(loop_ev, 0))
+                stop_flag = 1;
+    }
+    stats_record(stats, row, STAT_RENDER_WAIT, stats_now_ns() - t0);
+}
+
+static int spawn_player(const char *path, int pipefd[2], unsigned W, unsigned H, int turn_ms)
 {
     if (pipe(pipefd) == -1)
     {
@@ -123,6 +205,8 @@ static int spawn_player(const char *path, int pipefd[2], unsigned W, unsigned H)
     }
     if (pid == 0)
     {
+        sigprocmask(SIG_SETMASK, &child_sigmask, NULL);
+        die_with_master();
         /* Mantener stdout hacia el pipe */
         if (dup2(pipefd[1], 1) == -1)
         {
@@ -147,10 +231,12 @@ static int spawn_player(const char *path, int pipefd[2], unsigned W, unsigned H)
         close(pipefd[1]);
         /* Asegurar que no queden FDs heredados antes del exec */
         close_fds_except_stdio();
-        char wbuf[16], hbuf[16];
+        /* argv: W H y el timeout por jugador en ms (0 = sin límite), para bots con presupuesto */
+        char wbuf[16], hbuf[16], tbuf[16];
         snprintf(wbuf, sizeof(wbuf), "%u", W);
         snprintf(hbuf, sizeof(hbuf), "%u", H);
-        execl(path, path, wbuf, hbuf, (char *)NULL);
+        snprintf(tbuf, sizeof(tbuf), "%d", turn_ms);
+        execl(path, path, wbuf, hbuf, tbuf, (char *)NULL);
         perror("execl");
         _exit(127);
     }
@@ -168,6 +254,8 @@ static pid_t spawn_view(const char *path, unsigned W, unsigned H)
     }
     if (pid == 0)
     {
+        sigprocmask(SIG_SETMASK, &child_sigmask, NULL);
+        die_with_master();
         /* Redirigir stdout y stderr de la view a un log por PID. */
         char logpath[256];
         pid_t mypid = getpid();
@@ -197,12 +285,14 @@ int main(int argc, char *argv[])
     // tests de valgrind 
     (void)mkdir("./logs", 0755);
 
-    // señales
-    struct sigaction sa = {0};
-    sa.sa_handler = on_signal;
-    sigemptyset(&sa.sa_mask);
-    sigaction(SIGINT, &sa, NULL);
-    sigaction(SIGTERM, &sa, NULL);
+    // señales y loop de eventos (epoll + signalfd + timerfds)
+    MasterEvents ev;
+    if (events_init(&ev, &child_sigmask) != 0)
+    {
+        perror("events_init");
+        return 1;
+    }
+    loop_ev = &ev;
 
     /* parseo */
     MasterConfig cfg;
@@ -212,8 +302,28 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    unsigned W = (unsigned)cfg.width;
-    unsigned H = (unsigned)cfg.height;
+    /* shm en un namespace propio: players, vista y chompstat lo toman de CHOMP_SHM_NS */
+    master_pid = getpid();
+    if (setup_shm_namespace(cfg.shm_tag) != 0)
+        return 1;
+
+    /* log binario asíncrono; los players heredan el nivel por entorno */
+    char lvbuf[8];
+    snprintf(lvbuf, sizeof(lvbuf), "%d", cfg.log_level);
+    setenv(EVLOG_LEVEL_ENV, lvbuf, 1);
+    /* logs y replay con el mismo namespace que las shm: partidas simultáneas no se pisan */
+    char evpath[LOG_PATH_MAX], replay_default[LOG_PATH_MAX];
+    snprintf(evpath, sizeof(evpath), MASTER_EVLOG_PATH_FMT, shm_get_namespace());
+    if (evlog_open(evpath, cfg.log_level) != 0)
+        fprintf(stderr, "master: evlog_open('%s') failed: %s\n", evpath, strerror(errno));
+    if (!cfg.replay_off && !cfg.replay_path)
+    {
+        snprintf(replay_default, sizeof(replay_default), MASTER_REPLAY_PATH_FMT, shm_get_namespace());
+        cfg.replay_path = replay_default;
+    }
+
+    unsigned W = cfg.width;
+    unsigned H = cfg.height;
     unsigned N = (unsigned)cfg.player_count;
     if (N == 0)
     {
@@ -228,11 +338,12 @@ int main(int argc, char *argv[])
 
     const char *default_player_path = "./player";
 
-    /* SHMs */
-    GameState *G = (GameState *)state_create(W, H);
+    /* SHMs (las opciones de mapeo se heredan a players y vista por entorno) */
+    shm_set_map_flags(cfg.shm_flags);
+    GameState *G = (GameState *)state_create(W, H, (CellFormat)cfg.cell_format);
     if (!G)
     {
-        fprintf(stderr, "shm_create_map(/game_state) failed\n");
+        fprintf(stderr, "state_create(%ux%u) failed: %s\n", W, H, strerror(errno));
         exit(1);
     }
 
@@ -241,6 +352,9 @@ int main(int argc, char *argv[])
         fprintf(stderr, "sync_create failed\n");
         exit(1);
     }
+    /* antes de lanzar a los jugadores: lo leen al enviar su primer movimiento */
+    if (cfg.move_rings)
+        sync_enable_move_rings();
 
     /* estado inicial */
     state_write_begin();
@@ -259,10 +373,19 @@ int main(int argc, char *argv[])
     }
     state_write_end();
 
-    /* spawn view */
+    /* spawn view (en modo frames, con el segmento creado antes de lanzarla) */
     pid_t view_pid = -1;
+    FrameWriter *frames = NULL;
     if (cfg.view_path && cfg.view_path[0] != '\0')
     {
+        if (cfg.view_fps > 0)
+        {
+            frames = frames_create(G, (unsigned)cfg.view_fps);
+            if (frames)
+                sync_enable_view_frames();
+            else
+                fprintf(stderr, "master: frames_create failed (%s), view sincrónica\n", strerror(errno));
+        }
         view_pid = spawn_view(cfg.view_path, W, H);
     }
     int has_view = (view_pid > 0);
@@ -271,53 +394,68 @@ int main(int argc, char *argv[])
     int rfd[MAX_PLAYERS];
     pid_t pids[MAX_PLAYERS];
     int alive[MAX_PLAYERS];
-    int plogfd[MAX_PLAYERS];
 
     for (unsigned i = 0; i < N; ++i)
     {
         int pf[2];
         const char *pp = (cfg.player_paths[i] && cfg.player_paths[i][0]) ? cfg.player_paths[i]
                                                                          : default_player_path;
-        pids[i] = spawn_player(pp, pf, W, H);
+        pids[i] = spawn_player(pp, pf, W, H, cfg.player_timeout_ms > 0 ? cfg.player_timeout_ms : 0);
         rfd[i] = pf[0];
         set_cloexec(rfd[i]);
-        alive[i] = 1;
-        /* abrir descriptor para que el master pueda anotar los bytes recibidos en el log del player */
-        char logpath[256];
-        snprintf(logpath, sizeof(logpath), "./logs/player-%d.log", (int)pids[i]);
-        int lf = open(logpath, O_CREAT | O_WRONLY | O_APPEND
-#ifdef O_CLOEXEC
-                                   | O_CLOEXEC
-#endif
-                                   , 0644);
-        if (lf == -1)
-        {
-            fprintf(stderr, "master: open('%s') failed: %s\n", logpath, strerror(errno));
-            plogfd[i] = -1;
-        }
-        else
+        if (events_add_player(&ev, i, rfd[i]) != 0)
         {
-            plogfd[i] = lf;
-            dprintf(plogfd[i], "MASTER: opened log for pid=%d\n", (int)pids[i]);
+            perror("events_add_player");
+            exit(1);
         }
+        if (cfg.move_rings)
+            events_use_ring(&ev, i);
+        alive[i] = 1;
     }
 
-    /* PIDs en el estado */
+    /* PIDs y nombres (basename del ejecutable) en el estado */
     state_write_begin();
     for (unsigned i = 0; i < N; ++i)
+    {
+        const char *pp = (cfg.player_paths[i] && cfg.player_paths[i][0]) ? cfg.player_paths[i]
+                                                                         : default_player_path;
+        const char *slash = strrchr(pp, '/');
+        snprintf(G->P[i].name, NAME_LEN, "%s", slash ? slash + 1 : pp);
         G->P[i].pid = pids[i];
+    }
     state_write_end();
 
+    const int MAX_ROUNDS = 200;
+
+    /* replay: jugada 0 con nombres y posiciones iniciales; los turnos se agregan al aplicarlos */
+    ReplayWriter *replay = NULL;
+    if (cfg.replay_path)
+    {
+        replay = replay_create(cfg.replay_path, G, cfg.seed, replay_key_interval(G, MAX_ROUNDS));
+        if (!replay)
+            fprintf(stderr, "master: replay_create('%s') failed: %s\n", cfg.replay_path, strerror(errno));
+    }
+
+    /* latencias por turno en /game_stats (./chompstat las lee en vivo) */
+    StatsShm *stats = stats_create(G);
+    if (!stats)
+        fprintf(stderr, "master: stats_create failed: %s\n", strerror(errno));
+
     /* frame inicial (si hay vista) */
-    if (has_view)
+    if (frames)
+        (void)frames_publish(frames, G, 1);
+    else if (has_view)
         view_signal_update_ready();
 
     int rounds = 0;
-    const int MAX_ROUNDS = 200;
+
+    /* timeouts de control */
+    int valid_timeout_ms = (cfg.timeout > 0) ? cfg.timeout : 0;
+    int player_timeout_ms = (cfg.player_timeout_ms > 0) ? cfg.player_timeout_ms : 0;
 
     /* timeout entre válidas: arrancar el reloj ahora */
-    struct timespec last_valid_ts;
-    clock_gettime(CLOCK_MONOTONIC, &last_valid_ts);
+    if (events_set_valid_timeout(&ev, valid_timeout_ms) != 0)
+        perror("timerfd_settime");
 
     /* índice de inicio para round-robin rotatorio */
     unsigned rr_start = 0;
@@ -358,194 +496,113 @@ int main(int argc, char *argv[])
             break;
         }
 
-        /* timeouts de control */
-        int valid_timeout_ms = (cfg.timeout > 0) ? cfg.timeout : 0;
-        int player_timeout_ms = (cfg.player_timeout_ms > 0) ? cfg.player_timeout_ms : 0;
-
         for (unsigned k = 0; k < N && !stop_flag; ++k)
         {
             unsigned i = (rr_start + k) % N;
             if (!alive[i] || blocked[i])
                 continue;
 
-            /* chequeo de timeout global entre válidas */
-            if (valid_timeout_ms > 0)
-            {
-                long since_valid = ms_since(&last_valid_ts);
-                if (since_valid >= valid_timeout_ms)
-                {
-                    printf("termination: timeout between valid moves (%ld ms)\n", since_valid);
-                    stop_flag = 1;
-                    break;
-                }
-            }
-
             /* otorgar turno al jugador i */
+            uint64_t t_grant = stats_now_ns();
             player_signal_turn((int)i);
+            if (player_timeout_ms > 0)
+                (void)events_arm_turn(&ev, player_timeout_ms);
+
+            /* esperar movimiento del jugador i: un solo epoll atiende pipes, señales y timers */
+            uint8_t mv = 0;
+            EventKind evk = events_wait_player(&ev, i, &mv);
+            if (evk == EVT_MOVE)
+                stats_record(stats, i, STAT_GRANT_TO_MOVE, stats_now_ns() - t_grant);
+            switch (evk)
+            {
+            case EVT_STOP:
+                stop_flag = 1;
+                break;
+
+            case EVT_VALID_TIMEOUT:
+                printf("termination: timeout between valid moves (%ld ms)\n", events_ms_since_valid(&ev));
+                stop_flag = 1;
+                break;
+
+            case EVT_TURN_TIMEOUT:
+                /* timeout individual: contabilizamos y seguimos con el siguiente jugador */
+                state_write_begin();
+                G->P[i].timeouts += 1;
+                replay_record(replay, G, i, REPLAY_TIMEOUT, 0);
+                state_write_end();
+                evlog_emit(EVLOG_INFO, EV_TIMEOUT, i, (unsigned)rounds, 0, 0, 0, 0);
+                view_frame(has_view, frames, G, stats, i);
+                msleep_int(cfg.delay);
+                break;
 
-            /* esperar movimiento del jugador i en su pipe con timeout individual */
-            int remaining_ms = player_timeout_ms;
-            int got_event = 0; /* 1 si recibimos algo (movimiento/EOF/error) */
-            while (!got_event && !stop_flag)
+            case EVT_MOVE:
             {
-                /* chequear timeout global entre válidas durante la espera */
-                if (valid_timeout_ms > 0)
-                {
-                    long since_valid = ms_since(&last_valid_ts);
-                    if (since_valid >= valid_timeout_ms)
-                    {
-                        printf("termination: timeout between valid moves (%ld ms)\n", since_valid);
-                        stop_flag = 1;
-                        break;
-                    }
-                }
+                int gain = 0;
 
-                fd_set rfds;
-                FD_ZERO(&rfds);
-                FD_SET(rfd[i], &rfds);
-                struct timeval tv;
-                if (remaining_ms > 0)
+                uint64_t t_apply = stats_now_ns();
+                state_write_begin();
+                if (mv == 0xFF)
                 {
-                    tv.tv_sec = remaining_ms / 1000;
-                    tv.tv_usec = (remaining_ms % 1000) * 1000;
+                    blocked[i] = 1;
+                    G->P[i].blocked = 1;
+                    evlog_emit(EVLOG_INFO, EV_PASS, i, (unsigned)rounds, 0, 0, 0, 0);
+                    replay_record(replay, G, i, REPLAY_PASS, mv);
                 }
                 else
                 {
-                    tv.tv_sec = 0;
-                    tv.tv_usec = 0;
-                }
-                struct timespec t0;
-                clock_gettime(CLOCK_MONOTONIC, &t0);
-                int rv = select(rfd[i] + 1, &rfds, NULL, NULL, (player_timeout_ms > 0 ? &tv : NULL));
-                if (rv < 0)
-                {
-                    if (errno == EINTR)
-                        continue;
-                    perror("select");
-                    got_event = 1; /* tratamos como evento para avanzar */
-                    alive[i] = 0;
-                    close(rfd[i]);
-                    break;
-                }
-                if (rv == 0)
-                {
-                    if (player_timeout_ms <= 0)
-                        continue; /* sin timeout: seguimos esperando */
-                    /* timeout individual: contabilizamos y seguimos con el siguiente jugador */
-                    state_write_begin();
-                    G->P[i].timeouts += 1;
-                    state_write_end();
-                    if (plogfd[i] != -1)
-                        dprintf(plogfd[i], "TIMEOUT\n");
-                    if (has_view)
+                    int ok = (mv < 8) && rules_validate(G, (int)i, (Dir)mv, &gain);
+                    if (ok)
                     {
-                        view_signal_update_ready();
-                        view_wait_render_complete();
-                    }
-                    msleep_int(cfg.delay);
-                    break;
-                }
-
-                /* hay datos listos */
-                uint8_t mv;
-                ssize_t n = read(rfd[i], &mv, 1);
-                if (n == 1)
-                {
-                    got_event = 1;
-                    int gain = 0;
-                    if (plogfd[i] != -1)
-                        dprintf(plogfd[i], "mv=%u\n", (unsigned)mv);
-
-                    state_write_begin();
-                    if (mv == 0xFF)
-                    {
-                        blocked[i] = 1;
-                        G->P[i].blocked = 1;
-                        printf("[round %d] player %u PASS -> BLOCKED\n", rounds, i);
+                        rules_apply(G, (int)i, (Dir)mv);
+                        frames_mark_row(frames, G->P[i].y);
+                        evlog_emit(EVLOG_INFO, EV_VALID, i, (unsigned)rounds,
+                                   (uint32_t)mv | (uint32_t)gain << 8, G->P[i].score,
+                                   (uint32_t)G->P[i].x, (uint32_t)G->P[i].y);
+                        events_mark_valid(&ev);
                     }
                     else
                     {
-                        int ok = (mv < 8) && rules_validate(G, (int)i, (Dir)mv, &gain);
-                        if (ok)
-                        {
-                            rules_apply(G, (int)i, (Dir)mv);
-                            printf("[round %d] player %u VALID dir=%u gain=%d score=%u pos=(%u,%u)\n",
-                                   rounds, i, (unsigned)mv, gain,
-                                   G->P[i].score, (unsigned)G->P[i].x, (unsigned)G->P[i].y);
-                            clock_gettime(CLOCK_MONOTONIC, &last_valid_ts);
-                        }
-                        else
-                        {
-                            G->P[i].invalids++;
-                            printf("[round %d] player %u INVALID dir=%u (invalids=%u)\n",
-                                   rounds, i, (unsigned)mv, G->P[i].invalids);
-                        }
-                        blocked[i] = !player_can_move(G, (int)i);
-                        G->P[i].blocked = blocked[i];
-                        if (blocked[i])
-                            printf("player %u BLOCKED (no moves)\n", i);
-                    }
-                    state_write_end();
-
-                    if (has_view)
-                    {
-                        view_signal_update_ready();
-                        view_wait_render_complete();
-                    }
-                    msleep_int(cfg.delay);
-                }
-                else if (n == 0)
-                {
-                    got_event = 1;
-                    alive[i] = 0;
-                    close(rfd[i]);
-                    if (plogfd[i] != -1)
-                        dprintf(plogfd[i], "EOF\n");
-                    printf("player %u EOF\n", i);
-                    if (has_view)
-                    {
-                        view_signal_update_ready();
-                        view_wait_render_complete();
-                    }
-                    msleep_int(cfg.delay);
-                }
-                else
-                {
-                    if (errno == EINTR)
-                        continue;
-                    if (errno != EAGAIN && errno != EWOULDBLOCK)
-                    {
-                        got_event = 1;
-                        perror("read");
-                        alive[i] = 0;
-                        close(rfd[i]);
-                        if (plogfd[i] != -1)
-                            dprintf(plogfd[i], "ERROR read errno=%d\n", errno);
-                        if (has_view)
-                        {
-                            view_signal_update_ready();
-                            view_wait_render_complete();
-                        }
-                        msleep_int(cfg.delay);
+                        G->P[i].invalids++;
+                        evlog_emit(EVLOG_INFO, EV_INVALID, i, (unsigned)rounds, mv, G->P[i].invalids, 0, 0);
                     }
+                    blocked[i] = !player_can_move(G, (int)i);
+                    G->P[i].blocked = blocked[i];
+                    if (blocked[i])
+                        evlog_emit(EVLOG_INFO, EV_BLOCKED, i, (unsigned)rounds, 0, 0, 0, 0);
+                    replay_record(replay, G, i, ok ? REPLAY_VALID : REPLAY_INVALID, mv);
                 }
+                state_write_end();
+                stats_record(stats, i, STAT_APPLY, stats_now_ns() - t_apply);
+                /* despertar ya al jugador bloqueado (no espera al próximo poll) */
+                if (blocked[i])
+                    sync_broadcast();
+
+                view_frame(has_view, frames, G, stats, i);
+                msleep_int(cfg.delay);
+                break;
+            }
 
-                if (player_timeout_ms > 0)
-                {
-                    struct timespec t1;
-                    clock_gettime(CLOCK_MONOTONIC, &t1);
-                    long spent = (t1.tv_sec - t0.tv_sec) * 1000L + (t1.tv_nsec - t0.tv_nsec) / 1000000L;
-                    if (spent > 0 && remaining_ms > 0)
-                        remaining_ms = remaining_ms > (int)spent ? remaining_ms - (int)spent : 0;
-                }
+            case EVT_EOF:
+                alive[i] = 0;
+                events_close_player(&ev, i);
+                evlog_emit(EVLOG_ERROR, EV_EOF, i, (unsigned)rounds, 0, 0, 0, 0);
+                printf("player %u EOF\n", i);
+                view_frame(has_view, frames, G, stats, i);
+                msleep_int(cfg.delay);
+                break;
+
+            case EVT_ERROR:
+                evlog_emit(EVLOG_ERROR, EV_READ_ERROR, i, (unsigned)rounds, (uint32_t)errno, 0, 0, 0);
+                perror("read");
+                alive[i] = 0;
+                events_close_player(&ev, i);
+                view_frame(has_view, frames, G, stats, i);
+                msleep_int(cfg.delay);
+                break;
             }
         }
 
-        if (has_view)
-        {
-            view_signal_update_ready();
-            view_wait_render_complete();
-        }
+        view_frame(has_view, frames, G, stats, STATS_ROW_MASTER);
 
         int all_blocked2 = 1;
         for (unsigned i = 0; i < N; ++i)
@@ -561,6 +618,7 @@ int main(int argc, char *argv[])
         }
 
         rounds++;
+        stats_set_rounds(stats, (unsigned)rounds);
         if (rounds >= MAX_ROUNDS)
         {
             printf("max rounds reached\n");
@@ -572,23 +630,43 @@ int main(int argc, char *argv[])
     state_write_begin();
     G->game_over = true;
     state_write_end();
+    sync_broadcast();
 
-    if (has_view)
+    if (frames)
+        (void)frames_publish(frames, G, 1);
+    else if (has_view)
         view_signal_update_ready();
     // no esperamos render
 
+    /* con el broadcast los players salen solos (y vacían su log); SIGTERM sólo a los que tardan */
+    int status[MAX_PLAYERS] = {0};
+    int reaped[MAX_PLAYERS] = {0};
+    for (int waited = 0;; waited += EXIT_POLL_MS)
+    {
+        int pending = 0;
+        for (unsigned i = 0; i < N; ++i)
+            if (pids[i] > 0 && !reaped[i])
+            {
+                if (waitpid(pids[i], &status[i], WNOHANG) == pids[i])
+                    reaped[i] = 1;
+                else
+                    pending = 1;
+            }
+        if (!pending || waited >= EXIT_GRACE_MS || msleep_int(EXIT_POLL_MS))
+            break;
+    }
     for (unsigned i = 0; i < N; ++i)
-        if (pids[i] > 0)
+        if (pids[i] > 0 && !reaped[i])
             kill(pids[i], SIGTERM);
     for (unsigned i = 0; i < N; ++i)
         if (pids[i] > 0)
         {
-            int status = 0;
-            (void)waitpid(pids[i], &status, 0);
-            int exited = WIFEXITED(status);
-            int code = exited ? WEXITSTATUS(status) : -1;
-            int signaled = WIFSIGNALED(status);
-            int sig = signaled ? WTERMSIG(status) : 0;
+            if (!reaped[i])
+                reap_child(pids[i], &status[i], SIGKILL);
+            int exited = WIFEXITED(status[i]);
+            int code = exited ? WEXITSTATUS(status[i]) : -1;
+            int signaled = WIFSIGNALED(status[i]);
+            int sig = signaled ? WTERMSIG(status[i]) : 0;
             /* imprimir causa y puntaje */
             unsigned score = 0;
             state_read_begin();
@@ -605,17 +683,20 @@ int main(int argc, char *argv[])
     if (view_pid > 0)
     {
         int status = 0;
-        (void)waitpid(view_pid, &status, 0);
+        reap_child(view_pid, &status, SIGTERM);
         if (WIFEXITED(status))
             printf("view exited code=%d\n", WEXITSTATUS(status));
         else if (WIFSIGNALED(status))
             printf("view signaled sig=%d\n", WTERMSIG(status));
     }
+    frames_destroy(frames);
+    stats_destroy(stats);
 
-    /* cerrar logs abiertos por el master */
-    for (unsigned i = 0; i < N; ++i)
-        if (plogfd[i] != -1)
-            close(plogfd[i]);
+    events_destroy(&ev);
+
+    evlog_close();
+    if (replay_close(replay) != 0)
+        fprintf(stderr, "master: error escribiendo el replay '%s'\n", cfg.replay_path);
 
     printf("done after %d rounds\n", rounds);
 
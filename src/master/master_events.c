@@ -0,0 +1,350 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include "master_events.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include "sync.h"
+
+#define MILLISEC_PER_SEC 1000
+#define NANOSEC_PER_MILLISEC 1000000L
+#define NANOSEC_PER_SEC 1000000000L
+#define EPOLL_BATCH (MAX_PLAYERS + 3)
+
+/* tags en epoll_event.data.u32: 0..MAX_PLAYERS-1 son pipes de jugadores */
+enum { TAG_SIGNAL = 100, TAG_TURN_TIMER, TAG_VALID_TIMER };
+
+static int epoll_add(int epfd, int fd, uint32_t events, uint32_t tag)
+{
+    struct epoll_event e;
+    memset(&e, 0, sizeof(e));
+    e.events = events;
+    e.data.u32 = tag;
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &e);
+}
+
+static void timespec_add_ms(struct timespec *ts, int ms)
+{
+    ts->tv_sec += ms / MILLISEC_PER_SEC;
+    ts->tv_nsec += (long)(ms % MILLISEC_PER_SEC) * NANOSEC_PER_MILLISEC;
+    if (ts->tv_nsec >= NANOSEC_PER_SEC)
+    {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= NANOSEC_PER_SEC;
+    }
+}
+
+/* arma el timer entre válidas en forma absoluta: last_valid + timeout */
+static int arm_valid_deadline(MasterEvents *ev)
+{
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (ev->valid_timeout_ms > 0)
+    {
+        its.it_value = ev->last_valid;
+        timespec_add_ms(&its.it_value, ev->valid_timeout_ms);
+    }
+    return timerfd_settime(ev->valid_tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/* consume la expiración de un timerfd; 1 si realmente venció */
+static int timer_expired(int tfd)
+{
+    uint64_t ticks = 0;
+    ssize_t n = read(tfd, &ticks, sizeof(ticks));
+    return n == (ssize_t)sizeof(ticks) && ticks > 0;
+}
+
+int events_init(MasterEvents *ev, sigset_t *old_mask)
+{
+    memset(ev, 0, sizeof(*ev));
+    ev->epfd = ev->sigfd = ev->turn_tfd = ev->valid_tfd = -1;
+    for (unsigned i = 0; i < MAX_PLAYERS; ++i)
+        ev->P[i].fd = -1;
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    if (sigprocmask(SIG_BLOCK, &mask, old_mask) == -1)
+        return -1;
+
+    ev->epfd = epoll_create1(EPOLL_CLOEXEC);
+    ev->sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    ev->turn_tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ev->valid_tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (ev->epfd == -1 || ev->sigfd == -1 || ev->turn_tfd == -1 || ev->valid_tfd == -1)
+        return -1;
+
+    if (epoll_add(ev->epfd, ev->sigfd, EPOLLIN, TAG_SIGNAL) == -1 ||
+        epoll_add(ev->epfd, ev->turn_tfd, EPOLLIN, TAG_TURN_TIMER) == -1 ||
+        epoll_add(ev->epfd, ev->valid_tfd, EPOLLIN, TAG_VALID_TIMER) == -1)
+        return -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &ev->last_valid);
+    ev->ring_polled = ev->last_valid;
+    return 0;
+}
+
+int events_add_player(MasterEvents *ev, unsigned i, int fd)
+{
+    if (i >= MAX_PLAYERS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    int flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+        return -1;
+    EventsPlayer *p = &ev->P[i];
+    p->fd = fd;
+    p->qh = p->qn = 0;
+    p->ready = 0;
+    p->hup = 0;
+    p->ring = 0;
+    /* edge-triggered: cada byte pendiente se lee una vez a la cola local */
+    return epoll_add(ev->epfd, fd, EPOLLIN | EPOLLRDHUP | EPOLLET, i);
+}
+
+void events_close_player(MasterEvents *ev, unsigned i)
+{
+    if (i >= MAX_PLAYERS || ev->P[i].fd < 0)
+        return;
+    (void)epoll_ctl(ev->epfd, EPOLL_CTL_DEL, ev->P[i].fd, NULL);
+    close(ev->P[i].fd);
+    ev->P[i].fd = -1;
+    ev->P[i].ready = 0;
+    ev->P[i].qn = 0;
+}
+
+void events_use_ring(MasterEvents *ev, unsigned i)
+{
+    if (i < MAX_PLAYERS)
+        ev->P[i].ring = 1;
+}
+
+int events_set_valid_timeout(MasterEvents *ev, int timeout_ms)
+{
+    ev->valid_timeout_ms = timeout_ms > 0 ? timeout_ms : 0;
+    clock_gettime(CLOCK_MONOTONIC, &ev->last_valid);
+    return arm_valid_deadline(ev);
+}
+
+void events_mark_valid(MasterEvents *ev)
+{
+    /* el timer no se re-arma acá: al vencer se compara contra last_valid */
+    clock_gettime(CLOCK_MONOTONIC, &ev->last_valid);
+}
+
+static long ms_since(const struct timespec *t)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - t->tv_sec) * MILLISEC_PER_SEC +
+           (now.tv_nsec - t->tv_nsec) / NANOSEC_PER_MILLISEC;
+}
+
+long events_ms_since_valid(const MasterEvents *ev)
+{
+    return ms_since(&ev->last_valid);
+}
+
+int events_arm_turn(MasterEvents *ev, int timeout_ms)
+{
+    /* re-armar descarta expiraciones viejas del turno anterior */
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    ev->turn_armed = timeout_ms > 0;
+    if (timeout_ms > 0)
+    {
+        timespec_add_ms(&its.it_value, timeout_ms);
+        /* mismo vencimiento en absoluto, para acotar el sueño en el anillo */
+        clock_gettime(CLOCK_MONOTONIC, &ev->turn_deadline);
+        timespec_add_ms(&ev->turn_deadline, timeout_ms);
+    }
+    return timerfd_settime(ev->turn_tfd, 0, &its, NULL);
+}
+
+/* lee lo disponible del pipe a la cola local (vacía al llamar) */
+static EventKind fill_queue(EventsPlayer *p, int *again)
+{
+    *again = 0;
+    ssize_t n = read(p->fd, p->q, sizeof(p->q));
+    if (n > 0)
+    {
+        p->qh = 0;
+        p->qn = (unsigned)n;
+        /* lectura corta: el pipe quedó vacío salvo que ya se haya avisado EOF */
+        if ((size_t)n < sizeof(p->q) && !p->hup)
+            p->ready = 0;
+        return EVT_MOVE;
+    }
+    if (n == 0)
+        return EVT_EOF;
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+        p->ready = 0;
+        *again = 1;
+        return EVT_MOVE;
+    }
+    if (errno == EINTR)
+    {
+        *again = 1;
+        return EVT_MOVE;
+    }
+    return EVT_ERROR;
+}
+
+/* procesa un lote de epoll; 1 si la espera del jugador i termina con *out, 0 si hay que seguir */
+static int dispatch_events(MasterEvents *ev, unsigned i, int timeout_ms, EventKind *out)
+{
+    EventsPlayer *p = &ev->P[i];
+    struct epoll_event evs[EPOLL_BATCH];
+    int n = epoll_wait(ev->epfd, evs, EPOLL_BATCH, timeout_ms);
+    if (n < 0)
+    {
+        if (errno == EINTR)
+            return 0;
+        *out = EVT_ERROR;
+        return 1;
+    }
+
+    int stop = 0, valid_to = 0, turn_to = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        uint32_t tag = evs[k].data.u32;
+        if (tag < MAX_PLAYERS)
+        {
+            ev->P[tag].ready = 1;
+            if (evs[k].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR))
+                ev->P[tag].hup = 1;
+        }
+        else if (tag == TAG_SIGNAL)
+        {
+            struct signalfd_siginfo si;
+            while (read(ev->sigfd, &si, sizeof(si)) == (ssize_t)sizeof(si))
+                stop = 1;
+        }
+        else if (tag == TAG_TURN_TIMER)
+        {
+            turn_to = timer_expired(ev->turn_tfd);
+        }
+        else if (tag == TAG_VALID_TIMER && timer_expired(ev->valid_tfd))
+        {
+            if (events_ms_since_valid(ev) >= ev->valid_timeout_ms)
+                valid_to = 1;
+            else
+                (void)arm_valid_deadline(ev);
+        }
+    }
+
+    if (stop)
+        *out = EVT_STOP;
+    else if (valid_to)
+        *out = EVT_VALID_TIMEOUT;
+    else if (p->ready || (p->ring && move_ring_pending((int)i)))
+        return 0;
+    else if (turn_to)
+        *out = EVT_TURN_TIMEOUT;
+    else
+        return 0;
+    return 1;
+}
+
+/* plazo para dormir en el anillo: el fin del turno o RING_POLL_MS, lo que llegue antes */
+static void ring_deadline(const MasterEvents *ev, struct timespec *ts)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    timespec_add_ms(ts, RING_POLL_MS);
+    if (ev->turn_armed && (ev->turn_deadline.tv_sec < ts->tv_sec ||
+                           (ev->turn_deadline.tv_sec == ts->tv_sec && ev->turn_deadline.tv_nsec < ts->tv_nsec)))
+        *ts = ev->turn_deadline;
+}
+
+EventKind events_wait_player(MasterEvents *ev, unsigned i, uint8_t *mv)
+{
+    EventsPlayer *p = &ev->P[i];
+    for (;;)
+    {
+        if (p->qn > 0)
+        {
+            *mv = p->q[p->qh];
+            p->qh = (p->qh + 1) % EVENTS_QUEUE_LEN;
+            p->qn--;
+            return EVT_MOVE;
+        }
+        EventKind out;
+        if (p->ring)
+        {
+            /* con jugadas inmediatas el anillo nunca queda vacío: revisar fds igual cada tanto */
+            if (ms_since(&ev->ring_polled) >= RING_POLL_MS)
+            {
+                clock_gettime(CLOCK_MONOTONIC, &ev->ring_polled);
+                if (dispatch_events(ev, i, 0, &out))
+                    return out;
+            }
+            if (move_ring_pop((int)i, mv))
+                return EVT_MOVE;
+        }
+        if (p->ready)
+        {
+            int again = 0;
+            EventKind k = fill_queue(p, &again);
+            if (k != EVT_MOVE)
+                return k;
+            if (!again)
+            {
+                /* llegaron bytes por el pipe: este jugador no usa el anillo */
+                p->ring = 0;
+                continue;
+            }
+        }
+
+        if (p->ring)
+        {
+            /* el anillo no despierta al epoll: dormir en su futex y revisar fds sin bloquear */
+            struct timespec dl;
+            ring_deadline(ev, &dl);
+            if (move_ring_wait((int)i, &dl))
+                continue;
+            clock_gettime(CLOCK_MONOTONIC, &ev->ring_polled);
+            if (dispatch_events(ev, i, 0, &out))
+                return out;
+        }
+        else if (dispatch_events(ev, i, -1, &out))
+            return out;
+    }
+}
+
+int events_sleep(MasterEvents *ev, int ms)
+{
+    struct pollfd pfd = {.fd = ev->sigfd, .events = POLLIN, .revents = 0};
+    if (poll(&pfd, 1, ms > 0 ? ms : 0) <= 0)
+        return 0;
+    struct signalfd_siginfo si;
+    int stop = 0;
+    while (read(ev->sigfd, &si, sizeof(si)) == (ssize_t)sizeof(si))
+        stop = 1;
+    return stop;
+}
+
+void events_destroy(MasterEvents *ev)
+{
+    for (unsigned i = 0; i < MAX_PLAYERS; ++i)
+        events_close_player(ev, i);
+    if (ev->valid_tfd != -1)
+        close(ev->valid_tfd);
+    if (ev->turn_tfd != -1)
+        close(ev->turn_tfd);
+    if (ev->sigfd != -1)
+        close(ev->sigfd);
+    if (ev->epfd != -1)
+        close(ev->epfd);
+    ev->epfd = ev->sigfd = ev->turn_tfd = ev->valid_tfd = -1;
+}
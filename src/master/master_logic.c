@@ -7,22 +7,48 @@
 #include <getopt.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
 #include "master_logic.h"
+#include "state.h"
+#include "shm.h"
+#include "evlog.h"
+
+/* parsea un lado del tablero; -1 si no es un entero válido dentro de [10, STATE_MAX_SIDE] */
+static int parse_side(const char *s, unsigned *out) {
+    char *end = NULL;
+    errno = 0;
+    unsigned long v = strtoul(s, &end, 10);
+    if (errno != 0 || end == s || *end != '\0' || s[0] == '-' || v < 10 || v > STATE_MAX_SIDE)
+        return -1;
+    *out = (unsigned)v;
+    return 0;
+}
 
 static void print_usage(const char *prog) {
     fprintf(stderr,
         "Uso: %s "
         "[-w width] [-h height] "
         "[-d delay_ms] [-t timeout_s] "
-        "[-s seed] [-v ./view] "
+        "[-s seed] [-v ./view] [-c int|byte] [-m populate,thp,hugetlb] [-r] "
+        "[-l off|error|info] [-R replay|off] [-F fps] [-N tag] "
     "-p player\n\n"
         "Notas:\n"
-        "- width/height: mínimo 10 (default 10).\n"
+        "- width/height: mínimo 10, máximo %u (default 10).\n"
         "- d: delay entre impresiones en ms (default 200).\n"
         "- t: timeout para movimientos válidos en segundos (default 10s).\n"
         "- v: ruta de la vista (por ejemplo ./view_ncurses).\n"
-        "- p: entre 1 y 9 jugadores, ejecutables permitidos: 'player' o 'player2'.\n",
-        prog);
+        "- c: formato de celdas del tablero: 'int' (default) o 'byte' (1 byte por celda).\n"
+        "- m: mapeo de las shm: 'populate' (prefault), 'thp' (huge pages transparentes),\n"
+        "     'hugetlb' (memfd hugetlb, cae a páginas normales si no hay reservadas).\n"
+        "- r: los jugadores envían movimientos por anillos en memoria compartida\n"
+        "     (sin syscalls por jugada); sin -r se usan pipes.\n"
+        "- l: nivel del log binario logs/master.<ns>.evlog (default info); se lee con ./chomplog.\n"
+        "- R: archivo de replay (default logs/game.<ns>.replay, 'off' = no grabar); se lee con ./chompreplay.\n"
+        "- F: la view toma snapshots a su ritmo (hasta fps por segundo) y el master no la espera.\n"
+        "- N: etiqueta del namespace de las shm (quedan como /game_state.<tag>.<pid>; default <pid>),\n"
+        "     para correr varias partidas a la vez en el mismo host; <ns> = <tag>.<pid> o <pid>.\n"
+        "- p: entre 1 y 9 jugadores, ejecutables permitidos: 'player', 'player2' o 'player3'.\n",
+        prog, STATE_MAX_SIDE);
 }
 
 int parse_args(int argc, char *argv[], MasterConfig *config)
@@ -34,6 +60,14 @@ int parse_args(int argc, char *argv[], MasterConfig *config)
     config->player_timeout_ms = 0;      /* 0 = sin timeout individual */
     config->seed   = (unsigned int)time(NULL);
     config->view_path = NULL;
+    config->cell_format = CELL_FMT_INT;
+    config->shm_flags = 0;
+    config->move_rings = 0;
+    config->log_level = EVLOG_INFO;
+    config->replay_path = NULL;
+    config->replay_off = 0;
+    config->view_fps = 0;
+    config->shm_tag = NULL;
     config->player_count = 0;
     for (int i = 0; i < 9; ++i) config->player_paths[i] = NULL;
 
@@ -41,10 +75,16 @@ int parse_args(int argc, char *argv[], MasterConfig *config)
     optind = 1;
 
     int opt;
-    while ((opt = getopt(argc, argv, "w:h:d:t:T:s:v:p:")) != -1) {
+    while ((opt = getopt(argc, argv, "w:h:d:t:T:s:v:c:m:rl:R:F:N:p:")) != -1) {
         switch (opt) {
-        case 'w': config->width  = atoi(optarg); break;
-        case 'h': config->height = atoi(optarg); break;
+        case 'w':
+        case 'h':
+            if (parse_side(optarg, opt == 'w' ? &config->width : &config->height) != 0) {
+                fprintf(stderr, "Error: width/height deben ser enteros entre 10 y %u (recibido '%s').\n",
+                        STATE_MAX_SIDE, optarg);
+                return -1;
+            }
+            break;
         case 'd': config->delay  = atoi(optarg); break;
         case 't': {
             int tsec = atoi(optarg);
@@ -55,6 +95,41 @@ int parse_args(int argc, char *argv[], MasterConfig *config)
         case 'T': config->player_timeout_ms = atoi(optarg); break;  /* jugador */
         case 's': config->seed   = (unsigned int)atoi(optarg); break;
         case 'v': config->view_path = optarg; break;
+        case 'c':
+            if (strcmp(optarg, "int") == 0) config->cell_format = CELL_FMT_INT;
+            else if (strcmp(optarg, "byte") == 0) config->cell_format = CELL_FMT_BYTE;
+            else {
+                fprintf(stderr, "Error: formato de celdas inválido '%s' (permitidos: 'int', 'byte')\n", optarg);
+                return -1;
+            }
+            break;
+        case 'm':
+            if (shm_parse_map_flags(optarg, &config->shm_flags) != 0) {
+                fprintf(stderr, "Error: opción de mapeo inválida '%s' (permitidas: populate, thp, hugetlb)\n", optarg);
+                return -1;
+            }
+            break;
+        case 'r': config->move_rings = 1; break;
+        case 'l':
+            if (evlog_parse_level(optarg, &config->log_level) != 0) {
+                fprintf(stderr, "Error: nivel de log inválido '%s' (permitidos: off, error, info)\n", optarg);
+                return -1;
+            }
+            break;
+        case 'R':
+            config->replay_off = strcmp(optarg, "off") == 0;
+            config->replay_path = config->replay_off ? NULL : optarg;
+            break;
+        case 'F':
+            config->view_fps = atoi(optarg);
+            if (config->view_fps <= 0) {
+                fprintf(stderr, "Error: fps inválido '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        case 'N':
+            config->shm_tag = optarg;
+            break;
         case 'p':
             /* Consumir una lista de rutas hasta el próximo flag o fin. */
             optind--;
@@ -84,15 +159,16 @@ int parse_args(int argc, char *argv[], MasterConfig *config)
         fprintf(stderr, "Error: máximo 9 jugadores. Se pasaron %d.\n", config->player_count);
         return -1;
     }
-    if (config->width < 10 || config->height < 10) {
-        fprintf(stderr, "Error: width/height deben ser >= 10.\n");
+    if (state_size_checked(config->width, config->height, (CellFormat)config->cell_format, NULL) != 0) {
+        fprintf(stderr, "Error: tablero %ux%u demasiado grande para mapear.\n",
+                config->width, config->height);
         return -1;
     }
     if (config->delay < 0) config->delay = 0;
     if (config->timeout < 0) config->timeout = 0;
     if (config->player_timeout_ms < 0) config->player_timeout_ms = 0;
 
-    /* Validar que los ejecutables de players sean 'player' o 'player2' */
+    /* Validar que los ejecutables de players sean 'player', 'player2' o 'player3' */
     for (int i = 0; i < config->player_count; ++i) {
         const char *p = config->player_paths[i];
         if (!p || !*p) {
@@ -101,8 +177,8 @@ int parse_args(int argc, char *argv[], MasterConfig *config)
         }
         const char *slash = strrchr(p, '/');
         const char *base = slash ? slash + 1 : p;
-        if (strcmp(base, "player") != 0 && strcmp(base, "player2") != 0) {
-            fprintf(stderr, "Error: ejecutable de jugador inválido '%s' (permitidos: 'player', 'player2')\n", p);
+        if (strcmp(base, "player") != 0 && strcmp(base, "player2") != 0 && strcmp(base, "player3") != 0) {
+            fprintf(stderr, "Error: ejecutable de jugador inválido '%s' (permitidos: 'player', 'player2', 'player3')\n", p);
             return -1;
         }
     }
@@ -0,0 +1,28 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "bots.h"
+#include "rules.h"
+
+int bot_greedy_choose(const GameState *G, int my, uint8_t *out_dir)
+{
+    int best_gain = -1;
+    uint8_t best_dir = 0;
+    for (int d = 0; d < 8; ++d)
+    {
+        int gain = 0;
+        if (rules_validate(G, my, (Dir)d, &gain))
+        {
+            if (gain > best_gain)
+            {
+                best_gain = gain;
+                best_dir = (uint8_t)d;
+            }
+        }
+    }
+    if (best_gain >= 0)
+    {
+        *out_dir = best_dir;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <stdlib.h>
+#include <limits.h>
+#include "bots.h"
+#include "rules.h"
+
+#define EDGE_SAFE_MARGIN 2
+#define EDGE_PENALTY     2
+
+#define FREE_RADIUS 16
+#define FREE_RADIUS_MAX 31   /* ventana de 63 columnas: una palabra de 64 bits por fila */
+#define W_GAIN_BASE     50
+#define W_ALIGN_BASE     1
+#define ALIGN_DIV       50
+#define W_SPACE_BASE     1
+#define W_ENEMY_FEW      3
+#define W_ENEMY_MANY     6
+#define W_CENTER_LARGE   1
+#define W_TERRITORY      5    /* territorio cerrado: el BFS se agotó antes del horizonte */
+#define W_TERRITORY_OPEN 2    /* frentes abiertos al horizonte: el margen es sólo una tendencia */
+#define TERRITORY_HORIZON 32    /* pasos de BFS del territorio: acota el costo en tableros enormes */
+#define TERRITORY_MARGIN (2 * W_GAIN_BASE)  /* sólo se comparan por territorio jugadas a menos de esto de la mejor */
+#define TERRITORY_MAX_EVALS 3   /* voronoi_eval por turno como máximo */
+
+static const int NDX[8] = { 0, +1, +1, +1,  0, -1, -1, -1};
+static const int NDY[8] = {-1, -1,  0, +1, +1, +1,  0, -1};
+
+/* bits libres (en tablero y sin capturar) de la fila y en las columnas [x0, x0+n), n <= 64 */
+static uint64_t free_row_bits(const GameState *G, int x0, int n, int y)
+{
+    const int W = (int)G->w;
+    if (y < 0 || y >= (int)G->h)
+        return 0;
+    int lo = x0 < 0 ? 0 : x0;
+    int hi = x0 + n < W ? x0 + n : W;
+    if (lo >= hi)
+        return 0;
+    const uint64_t *row = occ_row(G, (unsigned)y);
+    unsigned wi = (unsigned)lo / OCC_WORD_BITS, sh = (unsigned)lo % OCC_WORD_BITS;
+    uint64_t occ = row[wi] >> sh;
+    if (sh != 0 && wi + 1 < occ_words_per_row(G->w))
+        occ |= row[wi + 1] << (OCC_WORD_BITS - sh);
+    unsigned len = (unsigned)(hi - lo);
+    uint64_t mask = len == OCC_WORD_BITS ? ~(uint64_t)0 : (((uint64_t)1 << len) - 1);
+    return (~occ & mask) << (lo - x0);
+}
+
+/* vecinos horizontales de cada bit, incluido el propio */
+static inline uint64_t spread(uint64_t m) { return m | (m << 1) | (m >> 1); }
+
+/*
+ * cuenta celdas libres alcanzables en ventana (nx,ny) con radio R (8-conectado).
+ * Relleno por dilatación de máscaras de fila: cada fila de la ventana es una
+ * palabra de bits libres y la región alcanzada crece una celda en las 8
+ * direcciones por barrido, alternando barridos hacia abajo y hacia arriba.
+ */
+int bot_free_space_window(const GameState *G, int nx, int ny, int R)
+{
+    if (R > FREE_RADIUS_MAX) R = FREE_RADIUS_MAX;
+    if (R < 0) R = 0;
+    if (nx < 0 || ny < 0 || nx >= (int)G->w || ny >= (int)G->h) return 0;
+    if (occ_test(G, (unsigned)nx, (unsigned)ny)) return 0;
+
+    const int side = 2*R + 1;
+    uint64_t freem[2*FREE_RADIUS_MAX + 1], reach[2*FREE_RADIUS_MAX + 1];
+    for (int r = 0; r < side; ++r)
+    {
+        freem[r] = free_row_bits(G, nx - R, side, ny - R + r);
+        reach[r] = 0;
+    }
+    reach[R] = (uint64_t)1 << R;
+
+    int changed = 1;
+    for (int pass = 0; changed; ++pass)
+    {
+        changed = 0;
+        for (int k = 0; k < side; ++k)
+        {
+            int r = (pass & 1) ? side - 1 - k : k;
+            uint64_t grow = spread(reach[r]);
+            if (r > 0) grow |= spread(reach[r - 1]);
+            if (r + 1 < side) grow |= spread(reach[r + 1]);
+            grow &= freem[r];
+            if (grow != reach[r])
+            {
+                reach[r] = grow;
+                changed = 1;
+            }
+        }
+    }
+
+    int count = 0;
+    for (int r = 0; r < side; ++r)
+        count += __builtin_popcountll(reach[r]);
+    return count;
+}
+
+/* vector global hacia zonas con recompensa, ponderado por distancia */
+void bot_reward_vector(const GameState *G, int x, int y, long long *out_vx, long long *out_vy)
+{
+    long long vx = 0, vy = 0;
+    const int W = (int)G->w, H = (int)G->h;
+    for (int cy = 0; cy < H; ++cy)
+    {
+        for (int cx = 0; cx < W; ++cx)
+        {
+            int v = cell_get(G, idx(G, (unsigned)cx, (unsigned)cy));
+            if (cell_owner(v) != -1) continue;
+            int r = cell_reward(v);
+            if (r <= 0) continue;
+            long long ddx = cx - x, ddy = cy - y;
+            long long dist = llabs(ddx) + llabs(ddy);
+            long long w = (r * 10) / (1 + dist);
+            vx += ddx * w;
+            vy += ddy * w;
+        }
+    }
+    *out_vx = vx; *out_vy = vy;
+}
+
+void bot_heuristic_init(HeuristicCtx *ctx)
+{
+    reward_index_init(&ctx->ri);
+    voronoi_work_init(&ctx->vw);
+    ctx->ri_external = false;
+}
+
+void bot_heuristic_free(HeuristicCtx *ctx)
+{
+    reward_index_free(&ctx->ri);
+    voronoi_work_free(&ctx->vw);
+}
+
+/* recompensa del territorio propio menos la del mejor rival si my se mueve a (nx,ny), ya ponderada */
+static long long territory_term(HeuristicCtx *ctx, const GameState *G, int my, int nx, int ny)
+{
+    VoronoiResult vr;
+    if (voronoi_eval(&ctx->vw, G, my, (unsigned)nx, (unsigned)ny, TERRITORY_HORIZON, &vr) != 0)
+        return 0;
+    long long best_other = 0;
+    for (unsigned k = 0; k < G->n_players; ++k)
+        if ((int)k != my && (long long)vr.reward[k] > best_other)
+            best_other = (long long)vr.reward[k];
+    long long w = vr.steps < TERRITORY_HORIZON ? W_TERRITORY : W_TERRITORY_OPEN;
+    return w * ((long long)vr.reward[my] - best_other);
+}
+
+int bot_heuristic_choose(const GameState *G, int my, HeuristicCtx *ctx, uint8_t *out_dir)
+{
+    long long base[8], best_base = LLONG_MIN;
+    int gains[8], nxs[8], nys[8];
+
+    const Player *me = &G->P[my];
+    const int x = (int)me->x;
+    const int y = (int)me->y;
+    const int W = (int)G->w;
+    const int H = (int)G->h;
+    const unsigned N = G->n_players;
+
+    const int W_GAIN = W_GAIN_BASE;
+    const long long cells = (long long)W * H;
+    const int W_ALIGN = W_ALIGN_BASE * (cells >= 200 ? 3 : 2);
+    const int W_SPACE = W_SPACE_BASE * (N >= 6 ? 2 : 1);
+    const int W_ENEMY = (N >= 6 ? W_ENEMY_MANY : W_ENEMY_FEW);
+    const int W_CENTER = (cells >= 200 ? W_CENTER_LARGE : 0);
+
+    long long gvx = 0, gvy = 0;
+    /* con sincronización externa (lectura optimista) el índice no se toca acá */
+    bool ri_ok = ctx != NULL && (ctx->ri_external ? reward_index_current(&ctx->ri, G)
+                                                  : reward_index_sync(&ctx->ri, G) == 0);
+    if (ri_ok)
+        reward_index_vector(&ctx->ri, G, x, y, &gvx, &gvy);
+    else
+        bot_reward_vector(G, x, y, &gvx, &gvy);
+
+    for (int d = 0; d < 8; ++d)
+    {
+        int gain = 0;
+        gains[d] = -1;
+        if (!rules_validate(G, my, (Dir)d, &gain))
+            continue;
+
+        int nx = x + NDX[d];
+        int ny = y + NDY[d];
+    if (nx < 0) nx = 0;
+    if (nx >= W) nx = W - 1;
+    if (ny < 0) ny = 0;
+    if (ny >= H) ny = H - 1;
+
+        int dist_left = nx;
+        int dist_right = (W - 1) - nx;
+        int dist_top = ny;
+        int dist_bottom = (H - 1) - ny;
+        int dist_edge = dist_left;
+        if (dist_right < dist_edge) dist_edge = dist_right;
+        if (dist_top < dist_edge) dist_edge = dist_top;
+        if (dist_bottom < dist_edge) dist_edge = dist_bottom;
+        int penalty = 0;
+        if (dist_edge < EDGE_SAFE_MARGIN)
+            penalty = (EDGE_SAFE_MARGIN - dist_edge) * EDGE_PENALTY;
+
+        int space = bot_free_space_window(G, nx, ny, FREE_RADIUS);
+
+        int dmin = 1000000;
+        for (unsigned k = 0; k < N; ++k)
+        {
+            if ((int)k == my) continue;
+            int px = (int)G->P[k].x;
+            int py = (int)G->P[k].y;
+            int ddx = abs(px - nx), ddy = abs(py - ny);
+            int cheb = ddx > ddy ? ddx : ddy;
+            if (cheb < dmin) dmin = cheb;
+        }
+        int enemy_threat = 0;
+        if (dmin <= 2) enemy_threat = 3 - dmin; 
+
+        long long align = NDX[d]*gvx + NDY[d]*gvy;
+
+        int cx = (W - 1) / 2;
+        int cy = (H - 1) / 2;
+        int dcx = abs(nx - cx), dcy = abs(ny - cy);
+        int dcenter = dcx > dcy ? dcx : dcy;
+
+        long long score = 0;
+        score += (long long)W_GAIN * gain;
+        score -= (long long)penalty;
+        score += (long long)W_SPACE * space;
+        score -= (long long)W_ENEMY * enemy_threat;
+        score += (long long)W_ALIGN * (align / ALIGN_DIV);
+        score -= (long long)W_CENTER * dcenter;
+
+        base[d] = score;
+        gains[d] = gain;
+        nxs[d] = nx;
+        nys[d] = ny;
+        if (score > best_base)
+            best_base = score;
+    }
+    if (best_base == LLONG_MIN)
+        return 0;
+
+    /* el territorio cuesta un voronoi_eval por jugada: sólo desempata entre las
+       mejores (a menos de TERRITORY_MARGIN), y nada si hay una sola */
+    bool cand[8] = {false};
+    int n_cand = 0;
+    for (; n_cand < TERRITORY_MAX_EVALS; ++n_cand)
+    {
+        int pick = -1;
+        for (int d = 0; d < 8; ++d)
+            if (gains[d] >= 0 && !cand[d] && base[d] >= best_base - TERRITORY_MARGIN &&
+                (pick < 0 || base[d] > base[pick] || (base[d] == base[pick] && gains[d] > gains[pick])))
+                pick = d;
+        if (pick < 0)
+            break;
+        cand[pick] = true;
+    }
+
+    long long best_score = LLONG_MIN;
+    int best_gain = -1;
+    uint8_t best_dir = 0;
+    for (int d = 0; d < 8; ++d)
+    {
+        if (!cand[d])
+            continue;
+        long long score = base[d];
+        if (ctx && n_cand > 1)
+            score += territory_term(ctx, G, my, nxs[d], nys[d]);
+        if (score > best_score || (score == best_score && gains[d] > best_gain))
+        {
+            best_score = score;
+            best_gain = gains[d];
+            best_dir = (uint8_t)d;
+        }
+    }
+    *out_dir = best_dir;
+    return 1;
+}
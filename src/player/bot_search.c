@@ -0,0 +1,524 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "bot_search.h"
+#include "rules.h"
+
+#define DIRECTIONS       8
+#define UCB_C            0.7     /* exploración de UCB1 (valores en [0,1]) */
+#define TREE_NODES       (1u << 16)  /* nodos del árbol por hilo; lleno, las hojas sólo hacen rollout */
+#define NO_MOVER         0xFF
+#define EPSILON_DIV      4       /* 1 de cada EPSILON_DIV jugadas de rollout es al azar */
+#define FALLBACK_ROLLOUTS 256    /* sin deadline ni tope */
+#define MAX_REWARD       9
+#define SEARCH_NAME      "player3"
+
+static const int SDX[DIRECTIONS] = { 0, +1, +1, +1,  0, -1, -1, -1};
+static const int SDY[DIRECTIONS] = {-1, -1,  0, +1, +1, +1,  0, -1};
+
+/* celda capturada durante un rollout, con su valor previo para deshacer */
+typedef struct UndoEntry {
+    unsigned x, y;
+    int old;
+} UndoEntry;
+
+/*
+ * Nodo del árbol UCT: el estado tras una secuencia de jugadas desde la raíz,
+ * en el orden de turnos del master. Con varios jugadores se usa max^n: cada
+ * nodo acumula el valor del jugador que hizo la jugada que lleva a él, y en
+ * cada nivel elige (UCB1) el jugador que mueve.
+ */
+typedef struct SearchNode {
+    uint32_t first;             /* primer hijo en el pool (hijos contiguos) */
+    uint8_t nchild;
+    uint8_t expanded;
+    uint8_t dir;                /* jugada que lleva a este nodo */
+    uint8_t mover;              /* quién la hizo (NO_MOVER en la raíz) */
+    uint32_t visits;
+    double value;               /* suma de valores de 'mover' en [0,1] */
+} SearchNode;
+
+/* posición en la secuencia de turnos: ronda 0 arranca en my, las siguientes en 0 */
+typedef struct Turn {
+    unsigned round, k;
+} Turn;
+
+typedef struct SearchWorker {
+    struct SearchBot *bot;
+    unsigned index;
+    GameState *board;           /* copia privada del estado raíz */
+    size_t cap;
+    UndoEntry *log;
+    unsigned nlog;
+    uint64_t rng;
+    SearchNode *nodes;          /* nodes[0] es la raíz; se reinicia en cada jugada */
+    unsigned nnodes;
+    uint32_t *path;             /* nodos recorridos en la iteración actual */
+} SearchWorker;
+
+struct SearchBot {
+    SearchConfig cfg;
+    SearchWorker *workers;
+    pthread_t *tids;
+    unsigned started;           /* hilos trabajadores lanzados (threads-1) */
+    pthread_mutex_t mu;
+    pthread_cond_t go, done;
+    unsigned generation, pending;
+    int quit;
+    /* trabajo de la jugada actual */
+    const GameState *root;
+    int my;
+    int has_deadline;
+    struct timespec deadline;
+    uint8_t cand[DIRECTIONS];
+    int ncand;
+};
+
+static uint64_t splitmix64(uint64_t *s)
+{
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int deadline_passed(const struct timespec *dl)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > dl->tv_sec || (now.tv_sec == dl->tv_sec && now.tv_nsec >= dl->tv_nsec);
+}
+
+/* aplica d para k registrando la celda destino */
+static void apply_logged(SearchWorker *w, int k, Dir d)
+{
+    GameState *g = w->board;
+    unsigned nx = (unsigned)((int)g->P[k].x + SDX[d]);
+    unsigned ny = (unsigned)((int)g->P[k].y + SDY[d]);
+    w->log[w->nlog].x = nx;
+    w->log[w->nlog].y = ny;
+    w->log[w->nlog].old = cell_get(g, idx(g, nx, ny));
+    w->nlog++;
+    rules_apply(g, k, d);
+}
+
+/* política de rollout: mayor ganancia con desempate al azar, o jugada al azar (epsilon) */
+static int rollout_pick(SearchWorker *w, int k, Dir *out)
+{
+    Dir valid[DIRECTIONS];
+    int nvalid = 0, best_gain = -1, nbest = 0;
+    Dir best[DIRECTIONS];
+    for (int d = 0; d < DIRECTIONS; ++d)
+    {
+        int gain = 0;
+        if (!rules_validate(w->board, k, (Dir)d, &gain))
+            continue;
+        valid[nvalid++] = (Dir)d;
+        if (gain > best_gain)
+        {
+            best_gain = gain;
+            nbest = 0;
+        }
+        if (gain == best_gain)
+            best[nbest++] = (Dir)d;
+    }
+    if (nvalid == 0)
+        return 0;
+    uint64_t r = splitmix64(&w->rng);
+    if (r % EPSILON_DIV == 0)
+        *out = valid[(r >> 8) % (uint64_t)nvalid];
+    else
+        *out = best[(r >> 8) % (uint64_t)nbest];
+    return 1;
+}
+
+/* próximo jugador que mueve desde t (inclusive); -1 si se agotó el horizonte de rondas */
+static int next_mover(SearchWorker *w, Turn *t, int *dead)
+{
+    const unsigned n = w->board->n_players;
+    while (t->round <= w->bot->cfg.rollout_rounds)
+    {
+        if (!dead[t->k])
+        {
+            if (player_can_move(w->board, (int)t->k))
+                return (int)t->k;
+            dead[t->k] = 1;
+        }
+        if (++t->k == n)
+        {
+            t->k = 0;
+            t->round++;
+        }
+    }
+    return -1;
+}
+
+static void advance(const GameState *g, Turn *t)
+{
+    if (++t->k == g->n_players)
+    {
+        t->k = 0;
+        t->round++;
+    }
+}
+
+/* crea los hijos de v para las jugadas válidas de k; 0 si el pool no alcanza */
+static int expand(SearchWorker *w, SearchNode *v, int k)
+{
+    uint8_t dirs[DIRECTIONS];
+    int nd = 0;
+    for (int d = 0; d < DIRECTIONS; ++d)
+        if (rules_validate(w->board, k, (Dir)d, NULL))
+            dirs[nd++] = (uint8_t)d;
+    if (w->nnodes + (unsigned)nd > TREE_NODES)
+        return 0;
+    v->first = w->nnodes;
+    v->nchild = (uint8_t)nd;
+    v->expanded = 1;
+    for (int c = 0; c < nd; ++c)
+    {
+        SearchNode *ch = &w->nodes[w->nnodes++];
+        memset(ch, 0, sizeof(*ch));
+        ch->dir = dirs[c];
+        ch->mover = (uint8_t)k;
+    }
+    return 1;
+}
+
+/* UCB1 entre los hijos de v, desde el punto de vista de quien mueve; primero los no visitados */
+static SearchNode *select_child(SearchWorker *w, const SearchNode *v)
+{
+    SearchNode *best = NULL;
+    double best_ucb = -1.0;
+    const double logn = log((double)(v->visits > 0 ? v->visits : 1));
+    for (unsigned c = 0; c < v->nchild; ++c)
+    {
+        SearchNode *ch = &w->nodes[v->first + c];
+        if (ch->visits == 0)
+            return ch;
+        double ucb = ch->value / ch->visits + UCB_C * sqrt(logn / ch->visits);
+        if (ucb > best_ucb)
+        {
+            best_ucb = ucb;
+            best = ch;
+        }
+    }
+    return best;
+}
+
+/*
+ * Una iteración de UCT: selección desde la raíz, expansión de una hoja ya
+ * visitada, rollout hasta completar rollout_rounds rondas y backprop. El
+ * tablero queda como estaba.
+ */
+static void iterate(SearchWorker *w, int my)
+{
+    GameState *g = w->board;
+    const unsigned n = g->n_players;
+    Player saved[MAX_PLAYERS];
+    memcpy(saved, g->P, sizeof(Player) * n);
+    GameStats saved_stats = g->stats;
+
+    int dead[MAX_PLAYERS];
+    for (unsigned k = 0; k < n; ++k)
+        dead[k] = g->P[k].blocked;
+
+    w->nlog = 0;
+    unsigned depth = 0;
+    w->path[depth++] = 0;
+    SearchNode *v = &w->nodes[0];
+    Turn t = {0, (unsigned)my};
+
+    /* selección y expansión: se baja mientras el nodo ya tenga hijos */
+    int k;
+    while ((k = next_mover(w, &t, dead)) >= 0)
+    {
+        if (!v->expanded && (v->visits == 0 || !expand(w, v, k)))
+            break;
+        SearchNode *ch = select_child(w, v);
+        apply_logged(w, k, (Dir)ch->dir);
+        advance(g, &t);
+        v = ch;
+        w->path[depth++] = (uint32_t)(v - w->nodes);
+    }
+
+    /* rollout: el resto de la secuencia de turnos con la política rápida */
+    while ((k = next_mover(w, &t, dead)) >= 0)
+    {
+        Dir d;
+        if (rollout_pick(w, k, &d))
+            apply_logged(w, k, d);
+        advance(g, &t);
+    }
+
+    /* valor de cada jugador: su ganancia contra el promedio de los demás, en [0,1] */
+    double gain[MAX_PLAYERS], total = 0.0;
+    for (unsigned j = 0; j < n; ++j)
+    {
+        gain[j] = (double)(g->P[j].score - saved[j].score);
+        total += gain[j];
+    }
+    const double span = 2.0 * MAX_REWARD * (w->bot->cfg.rollout_rounds + 1);
+    double val[MAX_PLAYERS];
+    for (unsigned j = 0; j < n; ++j)
+    {
+        double others = n > 1 ? (total - gain[j]) / (double)(n - 1) : 0.0;
+        double x = 0.5 + (gain[j] - others) / span;
+        val[j] = x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x);
+    }
+    for (unsigned i = 0; i < depth; ++i)
+    {
+        SearchNode *p = &w->nodes[w->path[i]];
+        p->visits++;
+        if (p->mover != NO_MOVER)
+            p->value += val[p->mover];
+    }
+
+    while (w->nlog > 0)
+    {
+        const UndoEntry *e = &w->log[--w->nlog];
+        cell_set(g, idx(g, e->x, e->y), e->old);
+        occ_clear(g, e->x, e->y);
+    }
+    memcpy(g->P, saved, sizeof(Player) * n);
+    g->stats = saved_stats;
+}
+
+/* la copia del hilo se reusa entre jugadas: sólo se le aplican las capturas nuevas de la raíz */
+static int worker_prepare(SearchWorker *w, const GameState *root)
+{
+    size_t size = state_size(root->w, root->h, (CellFormat)root->cell_format);
+    if (w->board && w->board->w == root->w && w->board->h == root->h &&
+        w->board->cell_format == root->cell_format)
+        return state_sync_copy(w->board, root) < 0 ? -1 : 0;
+    if (w->cap < size)
+    {
+        GameState *nb = realloc(w->board, size);
+        if (!nb)
+            return -1;
+        w->board = nb;
+        w->cap = size;
+    }
+    memcpy(w->board, root, size);
+    return 0;
+}
+
+static void worker_search(SearchBot *b, SearchWorker *w)
+{
+    w->nnodes = 1;
+    memset(&w->nodes[0], 0, sizeof(SearchNode));
+    w->nodes[0].mover = NO_MOVER;
+    if (worker_prepare(w, b->root) != 0)
+        return;
+    w->rng = b->cfg.seed ^ ((uint64_t)(w->index + 1) * 0xD1B54A32D192ED03ull)
+           ^ ((uint64_t)b->root->P[b->my].valids << 32);
+    /* la raíz se expande siempre: sus hijos son las candidatas */
+    if (!expand(w, &w->nodes[0], b->my))
+        return;
+
+    unsigned limit = b->cfg.max_rollouts;
+    if (limit == 0 && !b->has_deadline)
+        limit = FALLBACK_ROLLOUTS;
+
+    for (unsigned total = 0; limit == 0 || total < limit; ++total)
+    {
+        if (b->has_deadline && deadline_passed(&b->deadline))
+            break;
+        iterate(w, b->my);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    SearchWorker *w = arg;
+    SearchBot *b = w->bot;
+    unsigned seen = 0;
+    pthread_mutex_lock(&b->mu);
+    for (;;)
+    {
+        while (!b->quit && b->generation == seen)
+            pthread_cond_wait(&b->go, &b->mu);
+        if (b->quit)
+            break;
+        seen = b->generation;
+        pthread_mutex_unlock(&b->mu);
+
+        worker_search(b, w);
+
+        pthread_mutex_lock(&b->mu);
+        if (--b->pending == 0)
+            pthread_cond_signal(&b->done);
+    }
+    pthread_mutex_unlock(&b->mu);
+    return NULL;
+}
+
+SearchBot *search_create(const SearchConfig *cfg)
+{
+    SearchBot *b = calloc(1, sizeof(*b));
+    if (!b)
+        return NULL;
+    b->cfg = *cfg;
+    pthread_mutex_init(&b->mu, NULL);
+    pthread_cond_init(&b->go, NULL);
+    pthread_cond_init(&b->done, NULL);
+    if (b->cfg.threads == 0)
+        b->cfg.threads = 1;
+    if (b->cfg.rollout_rounds == 0)
+        b->cfg.rollout_rounds = SEARCH_DEFAULT_ROUNDS;
+
+    const unsigned nt = b->cfg.threads;
+    b->workers = calloc(nt, sizeof(SearchWorker));
+    b->tids = calloc(nt, sizeof(pthread_t));
+    if (!b->workers || !b->tids)
+    {
+        search_destroy(b);
+        return NULL;
+    }
+
+    /* jugadas de una iteración (árbol + rollout): a lo sumo una por turno del horizonte */
+    const size_t log_len = 1 + ((size_t)b->cfg.rollout_rounds + 1) * MAX_PLAYERS;
+    for (unsigned i = 0; i < nt; ++i)
+    {
+        b->workers[i].bot = b;
+        b->workers[i].index = i;
+        b->workers[i].log = malloc(log_len * sizeof(UndoEntry));
+        b->workers[i].path = malloc((log_len + 1) * sizeof(uint32_t));
+        b->workers[i].nodes = malloc(TREE_NODES * sizeof(SearchNode));
+        if (!b->workers[i].log || !b->workers[i].path || !b->workers[i].nodes)
+        {
+            search_destroy(b);
+            return NULL;
+        }
+    }
+    /* el hilo llamador hace de trabajador 0 */
+    for (unsigned i = 1; i < nt; ++i)
+    {
+        if (pthread_create(&b->tids[i], NULL, worker_main, &b->workers[i]) != 0)
+        {
+            search_destroy(b);
+            return NULL;
+        }
+        b->started++;
+    }
+    return b;
+}
+
+void search_destroy(SearchBot *b)
+{
+    if (!b)
+        return;
+    if (b->started > 0)
+    {
+        pthread_mutex_lock(&b->mu);
+        b->quit = 1;
+        pthread_cond_broadcast(&b->go);
+        pthread_mutex_unlock(&b->mu);
+        for (unsigned i = 1; i <= b->started; ++i)
+            pthread_join(b->tids[i], NULL);
+    }
+    pthread_mutex_destroy(&b->mu);
+    pthread_cond_destroy(&b->go);
+    pthread_cond_destroy(&b->done);
+    if (b->workers)
+    {
+        for (unsigned i = 0; i < b->cfg.threads; ++i)
+        {
+            free(b->workers[i].board);
+            free(b->workers[i].log);
+            free(b->workers[i].path);
+            free(b->workers[i].nodes);
+        }
+    }
+    free(b->workers);
+    free(b->tids);
+    free(b);
+}
+
+int search_choose(SearchBot *b, const GameState *G, int my, const struct timespec *deadline, uint8_t *out_dir)
+{
+    b->ncand = 0;
+    for (int d = 0; d < DIRECTIONS; ++d)
+        if (rules_validate(G, my, (Dir)d, NULL))
+            b->cand[b->ncand++] = (uint8_t)d;
+    if (b->ncand == 0)
+        return 0;
+    if (b->ncand == 1)
+    {
+        *out_dir = b->cand[0];
+        return 1;
+    }
+
+    b->root = G;
+    b->my = my;
+    b->has_deadline = (deadline != NULL);
+    if (deadline)
+        b->deadline = *deadline;
+
+    pthread_mutex_lock(&b->mu);
+    b->pending = b->started;
+    b->generation++;
+    pthread_cond_broadcast(&b->go);
+    pthread_mutex_unlock(&b->mu);
+
+    worker_search(b, &b->workers[0]);
+
+    pthread_mutex_lock(&b->mu);
+    while (b->pending > 0)
+        pthread_cond_wait(&b->done, &b->mu);
+    pthread_mutex_unlock(&b->mu);
+
+    /* paralelismo de raíz: gana la jugada más visitada sumando los árboles de todos los hilos */
+    unsigned long long visits[DIRECTIONS] = {0};
+    double value[DIRECTIONS] = {0};
+    for (unsigned i = 0; i < b->cfg.threads; ++i)
+    {
+        const SearchWorker *w = &b->workers[i];
+        if (w->nnodes == 0 || !w->nodes[0].expanded)
+            continue;
+        for (unsigned c = 0; c < w->nodes[0].nchild; ++c)
+        {
+            const SearchNode *ch = &w->nodes[w->nodes[0].first + c];
+            visits[ch->dir] += ch->visits;
+            value[ch->dir] += ch->value;
+        }
+    }
+    int best = b->cand[0];
+    for (int c = 1; c < b->ncand; ++c)
+    {
+        int d = b->cand[c];
+        if (visits[d] > visits[best] ||
+            (visits[d] == visits[best] && value[d] > value[best]))
+            best = d;
+    }
+    *out_dir = (uint8_t)best;
+    return 1;
+}
+
+unsigned search_suggest_threads(const GameState *G)
+{
+    long cpus = 0;
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        cpus = CPU_COUNT(&set);
+    if (cpus <= 0)
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0)
+        cpus = 1;
+
+    unsigned searchers = 0;
+    for (unsigned k = 0; k < G->n_players; ++k)
+        if (strncmp(G->P[k].name, SEARCH_NAME, NAME_LEN) == 0)
+            searchers++;
+    if (searchers == 0)
+        searchers = 1;
+    long others = (long)G->n_players - (long)searchers;
+    long share = (cpus - others) / (long)searchers;
+    return share > 1 ? (unsigned)share : 1u;
+}
@@ -11,13 +11,12 @@
 #include "state.h"
 #include "state_access.h"
 #include "sync.h"
-#include "rules.h"
+#include "evlog.h"
+#include "bots.h"
 
 #define MAX_INIT_TRIES 200       // Maximum number of attempts to find self in game state
 #define INIT_POLL_DELAY_MS 50    // Delay between init attempts in milliseconds
-#define TURN_WAIT_TIMEOUT_MS 150 // Timeout for waiting for turn
 #define PASS_SENTINEL 0xFF       // Value sent when no legal moves are available
-#define POLL_DELAY_MS 50         // General polling delay
 #define NANOSEC_PER_MS 1000000L  // Number of nanoseconds in a millisecond
 
 static int find_self_index(const GameState *G, pid_t me)
@@ -39,63 +38,47 @@ static void parse_dims(int argc, char *argv[], unsigned *w, unsigned *h)
     }
 }
 
+/* lee game_over/blocked sin tomar locks (seqlock); reintenta si el master escribía */
+static void read_status(const GameState *G, int my, bool *over, bool *blocked)
+{
+    unsigned seq;
+    do
+    {
+        seq = state_read_optimistic_begin();
+        *over = G->game_over;
+        *blocked = G->P[my].blocked;
+    } while (state_read_optimistic_retry(seq));
+}
+
 static int wait_for_turn_or_end(GameState *G, int my)
 {
+    /* la época se lee antes que el estado: un broadcast posterior no se pierde */
+    unsigned epoch = sync_broadcast_epoch();
     for (;;)
     {
-        int r = player_wait_turn_timed(my, TURN_WAIT_TIMEOUT_MS);
+        bool over, b;
+        read_status(G, my, &over, &b);
+        if (over || b)
+            return 0;
+        int r = player_wait_turn_or_broadcast(my, &epoch);
         if (r == 1)
             return 1;
         if (r < 0)
             return 0;
-        state_read_begin();
-        bool over = G->game_over;
-        bool b = G->P[my].blocked;
-        state_read_end();
-        if (over || b)
-            return 0;
-    }
-}
-
-static int choose_best_move(GameState *G, int my, uint8_t *out_dir)
-{
-    int best_gain = -1;
-    uint8_t best_dir = 0;
-    for (int d = 0; d < 8; ++d)
-    {
-        int gain = 0;
-        if (rules_validate(G, my, (Dir)d, &gain))
-        {
-            if (gain > best_gain)
-            {
-                best_gain = gain;
-                best_dir = (uint8_t)d;
-            }
-        }
-    }
-    if (best_gain >= 0)
-    {
-        *out_dir = best_dir;
-        return 1;
     }
-    return 0;
 }
 
 static void send_pass_and_wait(GameState *G, int my)
 {
-    uint8_t pass = PASS_SENTINEL;
-    ssize_t wr = write(1, &pass, 1);
-    (void)wr;
+    unsigned epoch = sync_broadcast_epoch();
+    (void)player_send_move(my, PASS_SENTINEL);
     while (1)
     {
-        state_read_begin();
-        bool over = G->game_over;
-        bool b = G->P[my].blocked;
-        state_read_end();
+        bool over, b;
+        read_status(G, my, &over, &b);
         if (over || b)
             break;
-        struct timespec ts = {.tv_sec = 0, .tv_nsec = POLL_DELAY_MS * NANOSEC_PER_MS};
-        nanosleep(&ts, NULL);
+        sync_wait_broadcast(&epoch);
     }
 }
 
@@ -139,26 +122,38 @@ int main(int argc, char *argv[])
     if (my < 0)
         return 0;
 
+    char evpath[64];
+    snprintf(evpath, sizeof(evpath), EVLOG_PLAYER_PATH_FMT, (int)me);
+    (void)evlog_open(evpath, evlog_level_from_env(EVLOG_OFF));
+
     while (1)
     {
         int got_turn = wait_for_turn_or_end(G, my);
         if (!got_turn)
             break; /* juego terminó o me bloquearon */
 
-        state_read_begin();
-        if (G->game_over || G->P[my].blocked)
+        uint64_t t0 = evlog_clock_ns();
+        /* lectura optimista: si el master escribió mientras elegíamos, se recalcula */
+        bool over, b;
+        uint8_t best_dir = 0;
+        int can_play = 0;
+        unsigned seq;
+        do
         {
-            state_read_end();
+            seq = state_read_optimistic_begin();
+            over = G->game_over;
+            b = G->P[my].blocked;
+            if (!over && !b)
+                can_play = bot_greedy_choose(G, my, &best_dir);
+        } while (state_read_optimistic_retry(seq));
+        if (over || b)
             break;
-        }
-        uint8_t best_dir = 0;
-        int can_play = choose_best_move(G, my, &best_dir);
-        state_read_end();
 
         if (can_play)
         {
-            ssize_t wres = write(1, &best_dir, 1);
-            (void)wres; // Suppress unused-result warning
+            (void)player_send_move(my, best_dir);
+            evlog_emit(EVLOG_INFO, EV_PLAYER_MOVE, (unsigned)my, 0, best_dir,
+                       (uint32_t)((evlog_clock_ns() - t0) / 1000), 0, 0);
         }
         else
         {
@@ -167,5 +162,6 @@ int main(int argc, char *argv[])
         }
     }
 
+    evlog_close();
     return 0;
 }
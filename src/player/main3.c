@@ -0,0 +1,239 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdbool.h>
+#include "state.h"
+#include "state_access.h"
+#include "sync.h"
+#include "evlog.h"
+#include "bot_search.h"
+
+#define MAX_INIT_TRIES 200
+#define INIT_POLL_DELAY_MS 50
+#define PASS_SENTINEL 0xFF
+#define NANOSEC_PER_MS 1000000L
+#define NANOSEC_PER_SEC 1000000000L
+#define DEFAULT_BUDGET_MS 50        /* sin -T en el master */
+#define BUDGET_NUM 3                /* se usa BUDGET_NUM/BUDGET_DEN del -T ... */
+#define BUDGET_DEN 4
+#define BUDGET_MARGIN_MS 2          /* ... y al menos este margen antes del vencimiento */
+#define THREADS_ENV "CHOMP_SEARCH_THREADS"
+
+static int find_self_index(const GameState *G, pid_t me)
+{
+    for (unsigned i = 0; i < G->n_players; ++i)
+        if (G->P[i].pid == me)
+            return (int)i;
+    return -1;
+}
+
+/* argv: path W H [timeout_ms por jugador] */
+static void parse_args(int argc, char *argv[], unsigned *w, unsigned *h, unsigned *turn_ms)
+{
+    *w = 0;
+    *h = 0;
+    *turn_ms = 0;
+    if (argc >= 3)
+    {
+        *w = (unsigned)strtoul(argv[1], NULL, 10);
+        *h = (unsigned)strtoul(argv[2], NULL, 10);
+    }
+    if (argc >= 4)
+        *turn_ms = (unsigned)strtoul(argv[3], NULL, 10);
+}
+
+/* lee game_over/blocked sin tomar locks (seqlock); reintenta si el master escribía */
+static void read_status(const GameState *G, int my, bool *over, bool *blocked)
+{
+    unsigned seq;
+    do
+    {
+        seq = state_read_optimistic_begin();
+        *over = G->game_over;
+        *blocked = G->P[my].blocked;
+    } while (state_read_optimistic_retry(seq));
+}
+
+static int wait_for_turn_or_end(GameState *G, int my)
+{
+    /* la época se lee antes que el estado: un broadcast posterior no se pierde */
+    unsigned epoch = sync_broadcast_epoch();
+    for (;;)
+    {
+        bool over, b;
+        read_status(G, my, &over, &b);
+        if (over || b)
+            return 0;
+        int r = player_wait_turn_or_broadcast(my, &epoch);
+        if (r == 1)
+            return 1;
+        if (r < 0)
+            return 0;
+    }
+}
+
+static void send_pass_and_wait(GameState *G, int my)
+{
+    unsigned epoch = sync_broadcast_epoch();
+    (void)player_send_move(my, PASS_SENTINEL);
+    while (1)
+    {
+        bool over, b;
+        read_status(G, my, &over, &b);
+        if (over || b)
+            break;
+        sync_wait_broadcast(&epoch);
+    }
+}
+
+static void timespec_add_ms(struct timespec *ts, long ms)
+{
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * NANOSEC_PER_MS;
+    if (ts->tv_nsec >= NANOSEC_PER_SEC)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= NANOSEC_PER_SEC;
+    }
+}
+
+static long elapsed_ms(const struct timespec *since)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000 + (now.tv_nsec - since->tv_nsec) / NANOSEC_PER_MS;
+}
+
+/* tiempo de búsqueda por jugada: una fracción del -T, dejando margen para escribir */
+static long budget_ms(unsigned turn_ms)
+{
+    if (turn_ms == 0)
+        return DEFAULT_BUDGET_MS;
+    long b = (long)turn_ms * BUDGET_NUM / BUDGET_DEN;
+    if ((long)turn_ms - b < BUDGET_MARGIN_MS)
+        b = (long)turn_ms - BUDGET_MARGIN_MS;
+    return b > 0 ? b : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    GameState *G = state_attach();
+    if (!G)
+        return 1;
+    if (sync_attach() != 0)
+        return 1;
+
+    unsigned argW, argH, turn_ms;
+    parse_args(argc, argv, &argW, &argH, &turn_ms);
+
+    pid_t me = getpid();
+    int my = -1;
+    unsigned threads = 1;
+
+    for (int tries = 0; tries < MAX_INIT_TRIES && my < 0; ++tries)
+    {
+        state_read_begin();
+        my = find_self_index(G, me);
+        bool over = G->game_over;
+        if (my >= 0)
+            threads = search_suggest_threads(G);
+        static int warned_size = 0;
+        if (!warned_size && argW && argH && (G->w != argW || G->h != argH))
+        {
+            fprintf(stderr, "player3: aviso: tamaño SHM=%ux%u difiere de argv=%ux%u\n",
+                    G->w, G->h, argW, argH);
+            warned_size = 1;
+        }
+        state_read_end();
+        if (over)
+            return 0;
+        if (my < 0)
+        {
+            struct timespec ts = {.tv_sec = 0, .tv_nsec = INIT_POLL_DELAY_MS * NANOSEC_PER_MS};
+            nanosleep(&ts, NULL);
+        }
+    }
+    if (my < 0)
+        return 0;
+
+    const char *env = getenv(THREADS_ENV);
+    if (env && strtoul(env, NULL, 10) > 0)
+        threads = (unsigned)strtoul(env, NULL, 10);
+
+    /* copia privada del estado: la búsqueda corre sin tocar la shm ni tomar locks.
+       Se copia entera una sola vez; en cada turno sólo se traen las celdas capturadas. */
+    GameState *root = state_alloc(G->w, G->h, (CellFormat)G->cell_format);
+    if (root)
+    {
+        state_read_begin();
+        memcpy(root, G, state_size(G->w, G->h, (CellFormat)G->cell_format));
+        state_read_end();
+    }
+    SearchConfig cfg = {
+        .threads = threads,
+        .max_rollouts = 0,
+        .rollout_rounds = SEARCH_DEFAULT_ROUNDS,
+        .seed = (uint64_t)me,
+    };
+    SearchBot *bot = root ? search_create(&cfg) : NULL;
+    if (!bot)
+    {
+        fprintf(stderr, "player3: no se pudo crear el buscador\n");
+        free(root);
+        return 1;
+    }
+    fprintf(stderr, "player3: %u hilos, presupuesto %ld ms por jugada\n", threads, budget_ms(turn_ms));
+    char evpath[64];
+    snprintf(evpath, sizeof(evpath), EVLOG_PLAYER_PATH_FMT, (int)me);
+    (void)evlog_open(evpath, evlog_level_from_env(EVLOG_OFF));
+
+    while (1)
+    {
+        int got_turn = wait_for_turn_or_end(G, my);
+        if (!got_turn)
+            break;
+
+        uint64_t t0 = evlog_clock_ns();
+        struct timespec start, deadline;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        deadline = start;
+        timespec_add_ms(&deadline, budget_ms(turn_ms));
+
+        /* bajo el lock de lectura: una lectura rota dejaría la copia persistente mal */
+        state_read_begin();
+        (void)state_sync_copy(root, G);
+        state_read_end();
+        if (root->game_over || root->P[my].blocked)
+            break;
+
+        uint8_t best_dir = 0;
+        if (search_choose(bot, root, my, &deadline, &best_dir))
+        {
+            /* si el -T ya venció el master contó el timeout: un byte tardío se leería en el
+               próximo turno como jugada (inválida) desde otra posición, así que se descarta */
+            if (turn_ms > 0 && elapsed_ms(&start) >= (long)turn_ms)
+                continue;
+            (void)player_send_move(my, best_dir);
+            evlog_emit(EVLOG_INFO, EV_PLAYER_MOVE, (unsigned)my, 0, best_dir,
+                       (uint32_t)((evlog_clock_ns() - t0) / 1000), 0, 0);
+        }
+        else
+        {
+            send_pass_and_wait(G, my);
+            break;
+        }
+    }
+
+    evlog_close();
+    search_destroy(bot);
+    free(root);
+    return 0;
+}
@@ -0,0 +1,214 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <stdlib.h>
+#include <string.h>
+#include "reward_index.h"
+
+#define RI_MAX_REWARD  9                            /* recompensas de 1..9 (board_fill_rewards) */
+#define RI_PULL_RADIUS (10 * RI_MAX_REWARD)         /* a esta distancia Manhattan el peso ya es 0 */
+
+void reward_index_init(RewardIndex *ri)
+{
+    memset(ri, 0, sizeof(*ri));
+}
+
+void reward_index_free(RewardIndex *ri)
+{
+    free(ri->lvl[0]);
+    reward_index_init(ri);
+}
+
+static uint64_t *node_at(const RewardIndex *ri, unsigned L, unsigned i, unsigned j)
+{
+    return &ri->lvl[L][(size_t)j * ri->lw[L] + i];
+}
+
+/** @brief (Re)dimensiona los niveles para un tablero w x h. */
+static int layout(RewardIndex *ri, unsigned w, unsigned h)
+{
+    unsigned lw = (w + RI_BLOCK - 1) >> RI_BLOCK_SHIFT;
+    unsigned lh = (h + RI_BLOCK - 1) >> RI_BLOCK_SHIFT;
+    size_t total = 0;
+    unsigned L = 0;
+    for (;;)
+    {
+        ri->lw[L] = lw;
+        ri->lh[L] = lh;
+        total += (size_t)lw * lh;
+        if ((lw == 1 && lh == 1) || L + 1 == RI_MAX_LEVELS)
+            break;
+        lw = (lw + 1) / 2;
+        lh = (lh + 1) / 2;
+        L++;
+    }
+    free(ri->lvl[0]);
+    uint64_t *mem = malloc(total * sizeof(uint64_t));
+    if (!mem)
+    {
+        reward_index_init(ri);
+        return -1;
+    }
+    ri->levels = L + 1;
+    for (unsigned k = 0; k < ri->levels; ++k)
+    {
+        ri->lvl[k] = mem;
+        mem += (size_t)ri->lw[k] * ri->lh[k];
+    }
+    ri->w = w;
+    ri->h = h;
+    return 0;
+}
+
+static int rebuild(RewardIndex *ri, const GameState *G)
+{
+    if (ri->lvl[0] == NULL || ri->w != G->w || ri->h != G->h)
+        if (layout(ri, G->w, G->h) != 0)
+            return -1;
+
+    memset(ri->lvl[0], 0, (size_t)ri->lw[0] * ri->lh[0] * sizeof(uint64_t));
+    for (unsigned y = 0; y < G->h; ++y)
+    {
+        uint64_t *row = node_at(ri, 0, 0, y >> RI_BLOCK_SHIFT);
+        for (unsigned x = 0; x < G->w; ++x)
+        {
+            int v = cell_get(G, idx(G, x, y));
+            if (cell_owner(v) != -1)
+                continue;
+            int r = cell_reward(v);
+            if (r <= 0)
+                continue;
+            row[x >> RI_BLOCK_SHIFT] += (uint64_t)r;
+        }
+    }
+    for (unsigned L = 1; L < ri->levels; ++L)
+    {
+        for (unsigned j = 0; j < ri->lh[L]; ++j)
+        {
+            for (unsigned i = 0; i < ri->lw[L]; ++i)
+            {
+                uint64_t acc = 0;
+                for (unsigned cj = 2 * j; cj < 2 * j + 2 && cj < ri->lh[L - 1]; ++cj)
+                {
+                    for (unsigned ci = 2 * i; ci < 2 * i + 2 && ci < ri->lw[L - 1]; ++ci)
+                    {
+                        acc += *node_at(ri, L - 1, ci, cj);
+                    }
+                }
+                *node_at(ri, L, i, j) = acc;
+            }
+        }
+    }
+
+    ri->n_players = G->n_players;
+    for (unsigned k = 0; k < G->n_players; ++k)
+    {
+        ri->seen_valids[k] = G->P[k].valids;
+        ri->seen_score[k] = G->P[k].score;
+    }
+    ri->rebuilds++;
+    return 0;
+}
+
+/** @brief Descuenta la recompensa r de la celda (x,y) en todos los niveles. */
+static void remove_reward(RewardIndex *ri, unsigned x, unsigned y, unsigned r)
+{
+    unsigned bx = x >> RI_BLOCK_SHIFT, by = y >> RI_BLOCK_SHIFT;
+    for (unsigned L = 0; L < ri->levels; ++L)
+        *node_at(ri, L, bx >> L, by >> L) -= r;
+}
+
+int reward_index_sync(RewardIndex *ri, const GameState *G)
+{
+    if (ri->lvl[0] == NULL || ri->w != G->w || ri->h != G->h || ri->n_players != G->n_players)
+        return rebuild(ri, G);
+
+    for (unsigned k = 0; k < G->n_players; ++k)
+    {
+        const Player *p = &G->P[k];
+        unsigned dv = p->valids - ri->seen_valids[k];
+        unsigned ds = p->score - ri->seen_score[k];
+        if (dv == 0 && ds == 0)
+            continue;
+        /* sólo un movimiento desde la última vez: la celda capturada es la posición actual */
+        if (dv != 1 || p->x >= G->w || p->y >= G->h)
+            return rebuild(ri, G);
+        if (ds != 0)
+            remove_reward(ri, p->x, p->y, ds);
+        ri->seen_valids[k] = p->valids;
+        ri->seen_score[k] = p->score;
+    }
+
+    if (*node_at(ri, ri->levels - 1, 0, 0) != G->stats.reward_sum)
+        return rebuild(ri, G);
+    return 0;
+}
+
+bool reward_index_current(const RewardIndex *ri, const GameState *G)
+{
+    if (ri->lvl[0] == NULL || ri->w != G->w || ri->h != G->h || ri->n_players != G->n_players)
+        return false;
+    for (unsigned k = 0; k < G->n_players; ++k)
+        if (G->P[k].valids != ri->seen_valids[k] || G->P[k].score != ri->seen_score[k])
+            return false;
+    return *node_at(ri, ri->levels - 1, 0, 0) == G->stats.reward_sum;
+}
+
+/** @brief Suma exacta celda a celda de un bloque base (misma fórmula que bot_reward_vector). */
+static void accumulate_block(const GameState *G, unsigned bi, unsigned bj, long long x, long long y,
+                             long long *vx, long long *vy)
+{
+    unsigned x0 = bi << RI_BLOCK_SHIFT, y0 = bj << RI_BLOCK_SHIFT;
+    unsigned x1 = x0 + RI_BLOCK < G->w ? x0 + RI_BLOCK : G->w;
+    unsigned y1 = y0 + RI_BLOCK < G->h ? y0 + RI_BLOCK : G->h;
+    for (unsigned cy = y0; cy < y1; ++cy)
+    {
+        size_t row = idx(G, 0, cy);
+        for (unsigned cx = x0; cx < x1; ++cx)
+        {
+            int v = cell_get(G, row + cx);
+            if (cell_owner(v) != -1)
+                continue;
+            int r = cell_reward(v);
+            if (r <= 0)
+                continue;
+            long long ddx = (long long)cx - x, ddy = (long long)cy - y;
+            long long dist = llabs(ddx) + llabs(ddy);
+            long long w = (r * 10) / (1 + dist);
+            *vx += ddx * w;
+            *vy += ddy * w;
+        }
+    }
+}
+
+static void accumulate(const RewardIndex *ri, const GameState *G, unsigned L, unsigned i, unsigned j,
+                       long long x, long long y, long long *vx, long long *vy)
+{
+    if (*node_at(ri, L, i, j) == 0)
+        return;
+
+    long long side = (long long)RI_BLOCK << L;
+    long long x0 = (long long)i * side, y0 = (long long)j * side;
+    long long x1 = x0 + side - 1, y1 = y0 + side - 1;
+    long long gx = x < x0 ? x0 - x : (x > x1 ? x - x1 : 0);
+    long long gy = y < y0 ? y0 - y : (y > y1 ? y - y1 : 0);
+    if (gx + gy >= RI_PULL_RADIUS)
+        return;
+
+    if (L == 0)
+    {
+        accumulate_block(G, i, j, x, y, vx, vy);
+        return;
+    }
+    for (unsigned cj = 2 * j; cj < 2 * j + 2 && cj < ri->lh[L - 1]; ++cj)
+        for (unsigned ci = 2 * i; ci < 2 * i + 2 && ci < ri->lw[L - 1]; ++ci)
+            accumulate(ri, G, L - 1, ci, cj, x, y, vx, vy);
+}
+
+void reward_index_vector(const RewardIndex *ri, const GameState *G, int x, int y,
+                         long long *out_vx, long long *out_vy)
+{
+    long long vx = 0, vy = 0;
+    accumulate(ri, G, ri->levels - 1, 0, 0, x, y, &vx, &vy);
+    *out_vx = vx;
+    *out_vy = vy;
+}
@@ -0,0 +1,232 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <stdlib.h>
+#include <string.h>
+#include "voronoi.h"
+
+void voronoi_work_init(VoronoiWork *vw)
+{
+    memset(vw, 0, sizeof(*vw));
+}
+
+void voronoi_work_free(VoronoiWork *vw)
+{
+    free(vw->mem);
+    voronoi_work_init(vw);
+}
+
+static int work_layout(VoronoiWork *vw, unsigned w, unsigned h)
+{
+    size_t words = occ_words_per_row(w);
+    size_t plane = words * h;
+    free(vw->mem);
+    /* claimed + front/next por jugador; en cero de entrada, después se limpia por zonas */
+    vw->mem = calloc(plane * (1 + 2 * MAX_PLAYERS), sizeof(uint64_t));
+    if (!vw->mem)
+    {
+        voronoi_work_init(vw);
+        return -1;
+    }
+    vw->w = w;
+    vw->h = h;
+    vw->words = words;
+    vw->claimed = vw->mem;
+    for (unsigned p = 0; p < MAX_PLAYERS; ++p)
+    {
+        vw->front[p] = vw->mem + plane * (1 + 2 * p);
+        vw->next[p] = vw->mem + plane * (2 + 2 * p);
+    }
+    return 0;
+}
+
+static inline void bit_set(uint64_t *plane, size_t words, unsigned x, unsigned y)
+{
+    plane[(size_t)y * words + x / OCC_WORD_BITS] |= (uint64_t)1 << (x % OCC_WORD_BITS);
+}
+
+/* vecinos horizontales (y la celda misma) de la palabra i, con acarreo entre palabras */
+static inline uint64_t hspread(const uint64_t *row, size_t i, size_t words)
+{
+    uint64_t m = row[i];
+    uint64_t s = m | (m << 1) | (m >> 1);
+    if (i > 0)
+        s |= row[i - 1] >> (OCC_WORD_BITS - 1);
+    if (i + 1 < words)
+        s |= row[i + 1] << (OCC_WORD_BITS - 1);
+    return s;
+}
+
+/* bits válidos de la palabra i (la última palabra de la fila puede estar incompleta) */
+static inline uint64_t valid_mask(unsigned w, size_t i)
+{
+    size_t rem = (size_t)w - i * OCC_WORD_BITS;
+    return rem >= OCC_WORD_BITS ? ~(uint64_t)0 : (((uint64_t)1 << rem) - 1);
+}
+
+int voronoi_eval(VoronoiWork *vw, const GameState *G, int mover, unsigned mx, unsigned my,
+                 unsigned max_steps, VoronoiResult *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (vw->mem == NULL || vw->w != G->w || vw->h != G->h)
+        if (work_layout(vw, G->w, G->h) != 0)
+            return -1;
+
+    const size_t words = vw->words;
+    const unsigned n = G->n_players;
+    unsigned active[MAX_PLAYERS];
+    unsigned na = 0;
+
+    /* caja (filas y palabras) del frente de cada jugador; crece una celda por paso */
+    long y0[MAX_PLAYERS], y1[MAX_PLAYERS], i0[MAX_PLAYERS], i1[MAX_PLAYERS];
+    long nbox[MAX_PLAYERS][4];
+    /* zona tocada por cada jugador (unión de sus cajas), para limpiar al final sólo eso;
+       cada cabeza se limpia aparte porque las bloqueadas no tienen caja */
+    long ty0[MAX_PLAYERS], ty1[MAX_PLAYERS], ti0[MAX_PLAYERS], ti1[MAX_PLAYERS];
+    unsigned head_x[MAX_PLAYERS], head_y[MAX_PLAYERS];
+    int has_head[MAX_PLAYERS] = {0}, touched[MAX_PLAYERS] = {0};
+    for (unsigned p = 0; p < n; ++p)
+    {
+        unsigned hx = G->P[p].x, hy = G->P[p].y;
+        if ((int)p == mover)
+        {
+            hx = mx;
+            hy = my;
+        }
+        if (hx >= G->w || hy >= G->h)
+            continue;
+        /* las cabezas nunca son territorio de nadie */
+        bit_set(vw->claimed, words, hx, hy);
+        head_x[p] = hx;
+        head_y[p] = hy;
+        has_head[p] = 1;
+        if (G->P[p].blocked)
+            continue;
+        bit_set(vw->front[p], words, hx, hy);
+        y0[p] = y1[p] = ty0[p] = ty1[p] = hy;
+        i0[p] = i1[p] = ti0[p] = ti1[p] = hx / OCC_WORD_BITS;
+        touched[p] = 1;
+        active[na++] = p;
+    }
+
+    unsigned step = 0;
+    while (na > 0 && (max_steps == 0 || step < max_steps))
+    {
+        step++;
+
+        /* 1) frente candidato de cada jugador: dilatación 8-conexa sobre celdas libres sin asignar */
+        for (unsigned a = 0; a < na; ++a)
+        {
+            unsigned p = active[a];
+            if (y0[p] > 0) y0[p]--;
+            if (y1[p] + 1 < (long)G->h) y1[p]++;
+            if (i0[p] > 0) i0[p]--;
+            if (i1[p] + 1 < (long)words) i1[p]++;
+            if (y0[p] < ty0[p]) ty0[p] = y0[p];
+            if (y1[p] > ty1[p]) ty1[p] = y1[p];
+            if (i0[p] < ti0[p]) ti0[p] = i0[p];
+            if (i1[p] > ti1[p]) ti1[p] = i1[p];
+
+            const uint64_t *f = vw->front[p];
+            for (long y = y0[p]; y <= y1[p]; ++y)
+            {
+                const uint64_t *occ = occ_row(G, (unsigned)y);
+                const uint64_t *cl = vw->claimed + (size_t)y * words;
+                for (long i = i0[p]; i <= i1[p]; ++i)
+                {
+                    uint64_t d = hspread(f + (size_t)y * words, (size_t)i, words);
+                    if (y > 0)
+                        d |= hspread(f + (size_t)(y - 1) * words, (size_t)i, words);
+                    if (y + 1 < (long)G->h)
+                        d |= hspread(f + (size_t)(y + 1) * words, (size_t)i, words);
+                    uint64_t open = ~occ[i] & ~cl[i] & valid_mask(G->w, (size_t)i);
+                    vw->next[p][(size_t)y * words + i] = d & open;
+                }
+            }
+        }
+
+        /* 2) resolver empates: lo alcanzado por dos o más en el mismo paso queda neutral.
+              Fuera de su caja el plano next de cada jugador está en cero. */
+        for (unsigned a = 0; a < na; ++a)
+        {
+            unsigned p = active[a];
+            long ny0 = (long)G->h, ny1 = -1, ni0 = (long)words, ni1 = -1;
+            for (long y = y0[p]; y <= y1[p]; ++y)
+            {
+                for (long i = i0[p]; i <= i1[p]; ++i)
+                {
+                    size_t k = (size_t)y * words + (size_t)i;
+                    uint64_t mine = vw->next[p][k];
+                    if (!mine)
+                    {
+                        vw->front[p][k] = 0;
+                        continue;
+                    }
+                    uint64_t others = 0;
+                    for (unsigned b2 = 0; b2 < na; ++b2)
+                        if (b2 != a)
+                            others |= vw->next[active[b2]][k];
+                    uint64_t own = mine & ~others;
+                    /* cada celda disputada se cuenta una vez: desde el primer jugador que la alcanza */
+                    for (unsigned b2 = 0; b2 < a; ++b2)
+                        mine &= ~vw->next[active[b2]][k];
+                    out->contested += (uint64_t)__builtin_popcountll(mine & others);
+                    vw->front[p][k] = own;
+                    if (!own)
+                        continue;
+                    if (y < ny0) ny0 = y;
+                    if (y > ny1) ny1 = y;
+                    if (i < ni0) ni0 = i;
+                    if (i > ni1) ni1 = i;
+                    out->cells[p] += (uint64_t)__builtin_popcountll(own);
+                    for (uint64_t bits = own; bits; bits &= bits - 1)
+                    {
+                        unsigned x = (unsigned)i * OCC_WORD_BITS + (unsigned)__builtin_ctzll(bits);
+                        out->reward[p] += (uint64_t)cell_reward(cell_get(G, idx(G, x, (unsigned)y)));
+                    }
+                }
+            }
+            /* la caja nueva se guarda aparte: las demás resoluciones usan todavía la vieja */
+            nbox[p][0] = ny0; nbox[p][1] = ny1; nbox[p][2] = ni0; nbox[p][3] = ni1;
+        }
+
+        /* 3) marcar lo alcanzado, vaciar next y achicar las cajas al frente nuevo */
+        unsigned still = 0;
+        for (unsigned a = 0; a < na; ++a)
+        {
+            unsigned p = active[a];
+            for (long y = y0[p]; y <= y1[p]; ++y)
+            {
+                size_t k = (size_t)y * words;
+                for (long i = i0[p]; i <= i1[p]; ++i)
+                {
+                    vw->claimed[k + i] |= vw->next[p][k + i];
+                    vw->next[p][k + i] = 0;
+                }
+            }
+            y0[p] = nbox[p][0]; y1[p] = nbox[p][1];
+            i0[p] = nbox[p][2]; i1[p] = nbox[p][3];
+            if (y1[p] >= y0[p])
+                active[still++] = p;
+        }
+        na = still;
+    }
+    out->steps = step;
+
+    /* limpiar para la próxima evaluación sólo lo que tocó cada jugador: front y claimed
+       dentro de su caja (next ya quedó en cero en el paso 3) y las cabezas */
+    for (unsigned p = 0; p < n; ++p)
+    {
+        if (has_head[p])
+            vw->claimed[(size_t)head_y[p] * words + head_x[p] / OCC_WORD_BITS] = 0;
+        if (!touched[p])
+            continue;
+        size_t span = (size_t)(ti1[p] - ti0[p] + 1) * sizeof(uint64_t);
+        for (long y = ty0[p]; y <= ty1[p]; ++y)
+        {
+            size_t k = (size_t)y * words + (size_t)ti0[p];
+            memset(vw->claimed + k, 0, span);
+            memset(vw->front[p] + k, 0, span);
+        }
+    }
+    return 0;
+}
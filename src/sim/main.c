@@ -0,0 +1,196 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "sim.h"
+#include "bots.h"
+#include "bot_search.h"
+
+#define DEFAULT_GAMES 1000
+#define SIM_SEARCH_ROLLOUTS 200     /* player3 en la sim: tope fijo de iteraciones, sin reloj */
+
+static int policy_player(const GameState *G, int my, void *ctx, uint8_t *out_dir)
+{
+    (void)ctx;
+    return bot_greedy_choose(G, my, out_dir);
+}
+
+static int policy_player2(const GameState *G, int my, void *ctx, uint8_t *out_dir)
+{
+    return bot_heuristic_choose(G, my, (HeuristicCtx *)ctx, out_dir);
+}
+
+static int policy_player3(const GameState *G, int my, void *ctx, uint8_t *out_dir)
+{
+    return search_choose((SearchBot *)ctx, G, my, NULL, out_dir);
+}
+
+static SimPolicyFn policy_by_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    const char *base = slash ? slash + 1 : path;
+    if (strcmp(base, "player") == 0)
+        return policy_player;
+    if (strcmp(base, "player2") == 0)
+        return policy_player2;
+    if (strcmp(base, "player3") == 0)
+        return policy_player3;
+    return NULL;
+}
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+        "Uso: %s [-w width] [-h height] [-g games] [-s seed] [-c int|byte] [-r rounds] [-R replay] -p player [player2 ...]\n\n"
+        "Notas:\n"
+        "- g: cantidad de partidas a simular (default %d).\n"
+        "- s: semilla inicial; la partida k usa seed+k.\n"
+        "- r: límite de rondas por partida (default %d).\n"
+        "- R: graba la primera partida en ese archivo (se lee con ./chompreplay).\n"
+        "- c: formato de celdas del tablero, 'int' (default) o 'byte'.\n"
+        "- p: entre 1 y 9 políticas: 'player', 'player2' o 'player3' (%d rollouts por jugada).\n",
+        prog, DEFAULT_GAMES, SIM_MAX_ROUNDS, SIM_SEARCH_ROLLOUTS);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned w = 10, h = 10, games = DEFAULT_GAMES, max_rounds = SIM_MAX_ROUNDS;
+    const char *replay_path = NULL;
+    unsigned seed = (unsigned)time(NULL);
+    SimPolicy policies[MAX_PLAYERS];
+    const char *names[MAX_PLAYERS];
+    HeuristicCtx heuristics[MAX_PLAYERS];
+    SearchBot *searchers[MAX_PLAYERS] = {0};
+    unsigned n = 0;
+    CellFormat fmt = CELL_FMT_INT;
+
+    opterr = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:g:s:c:r:R:p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w': w = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'h': h = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'g': games = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 's': seed = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'r': max_rounds = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'R': replay_path = optarg; break;
+        case 'c':
+            if (strcmp(optarg, "byte") == 0)
+                fmt = CELL_FMT_BYTE;
+            else if (strcmp(optarg, "int") == 0)
+                fmt = CELL_FMT_INT;
+            else
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'p':
+            optind--;
+            while (optind < argc && argv[optind][0] != '-')
+            {
+                if (n >= MAX_PLAYERS)
+                {
+                    fprintf(stderr, "Error: máximo %d jugadores.\n", MAX_PLAYERS);
+                    return 1;
+                }
+                SimPolicyFn fn = policy_by_name(argv[optind]);
+                if (!fn)
+                {
+                    fprintf(stderr, "Error: política inválida '%s' (permitidas: 'player', 'player2', 'player3')\n", argv[optind]);
+                    return 1;
+                }
+                names[n] = argv[optind];
+                policies[n].choose = fn;
+                bot_heuristic_init(&heuristics[n]);
+                policies[n].ctx = (fn == policy_player2) ? &heuristics[n] : NULL;
+                if (fn == policy_player3)
+                {
+                    SearchConfig sc = {.threads = 1, .max_rollouts = SIM_SEARCH_ROLLOUTS,
+                                       .rollout_rounds = SEARCH_DEFAULT_ROUNDS, .seed = n};
+                    searchers[n] = search_create(&sc);
+                    if (!searchers[n])
+                    {
+                        perror("search_create");
+                        return 1;
+                    }
+                    policies[n].ctx = searchers[n];
+                }
+                n++;
+                optind++;
+            }
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (n == 0 || w < 10 || h < 10 || max_rounds == 0)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    SimGame s;
+    if (sim_init(&s, w, h, n, fmt) != 0)
+    {
+        perror("sim_init");
+        return 1;
+    }
+    s.max_rounds = max_rounds;
+
+    unsigned long long wins[MAX_PLAYERS] = {0};
+    unsigned long long total_rounds = 0;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (unsigned g = 0; g < games; ++g)
+    {
+        sim_reset(&s, seed + g);
+        if (g == 0 && replay_path)
+        {
+            s.replay = replay_create(replay_path, s.G, seed, replay_key_interval(s.G, max_rounds));
+            if (!s.replay)
+            {
+                perror(replay_path);
+                return 1;
+            }
+        }
+        total_rounds += sim_run(&s, policies);
+        if (s.replay)
+        {
+            if (replay_close(s.replay) != 0)
+                fprintf(stderr, "Error escribiendo el replay '%s'\n", replay_path);
+            s.replay = NULL;
+        }
+
+        unsigned best = 0;
+        for (unsigned i = 1; i < n; ++i)
+            if (s.G->P[i].score > s.G->P[best].score)
+                best = i;
+        wins[best]++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double elapsed = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("games=%u board=%ux%u players=%u elapsed=%.3fs\n", games, w, h, n, elapsed);
+    printf("games/sec=%.1f avg_rounds=%.1f\n",
+           elapsed > 0 ? (double)games / elapsed : 0.0,
+           games ? (double)total_rounds / games : 0.0);
+    for (unsigned i = 0; i < n; ++i)
+        printf("P%c  %-8s wins=%llu\n", 'A' + i, names[i], wins[i]);
+
+    sim_free(&s);
+    for (unsigned i = 0; i < n; ++i)
+    {
+        bot_heuristic_free(&heuristics[i]);
+        search_destroy(searchers[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,590 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "bots.h"
+#include "rules.h"
+#include "shm.h"
+#include "sim.h"
+#include "state_access.h"
+#include "sync.h"
+
+#define BENCH_PLAYERS 4
+#define BENCH_FREE_RADIUS 16        /* mismo radio que usa player2 */
+#define BENCH_TERRITORY_HORIZON 32  /* mismo horizonte de territorio que player2 */
+#define BENCH_BATCH_NS 20000ull     /* cada muestra dura al menos esto: amortiza clock_gettime */
+#define BENCH_MIN_SAMPLES 5
+#define BENCH_MAX_SAMPLES 2000
+#define BENCH_WALK_MAX 256          /* jugadas de rules_apply por muestra antes de deshacer */
+#define BENCH_PLACE_PLAYERS 256     /* jugadores por operación de placement (más que MAX_PLAYERS a propósito) */
+#define DEFAULT_BUDGET_MS 100
+#define DEFAULT_SEED 12345u
+#define DEFAULT_SIZES "10,64,256,1024,4096"
+#define DEFAULT_FILLS "0,25,50,75,95"
+#define MAX_LIST 32
+#define NANOSEC_PER_SEC 1000000000ull
+
+static const int DX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int DY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+/* acumula los resultados de cada kernel para que el compilador no los descarte */
+static volatile uint64_t bench_sink;
+
+/**
+ * @brief Tablero preparado para medir: estado, contexto de player2 y una
+ *        caminata válida de P0 que rules_apply recorre y después se deshace.
+ */
+typedef struct {
+    GameState *G;
+    unsigned fill;                      /* % de celdas capturadas */
+    HeuristicCtx hctx;
+    uint8_t walk[BENCH_WALK_MAX];
+    unsigned walk_x[BENCH_WALK_MAX], walk_y[BENCH_WALK_MAX];
+    int walk_old[BENCH_WALK_MAX];       /* valor de cada celda antes de capturarla */
+    unsigned walk_len;
+    Player p0;                          /* P0 y agregados antes de la caminata */
+    GameStats stats;
+    unsigned cursor;                    /* rota jugadores y direcciones entre llamadas */
+} BenchCase;
+
+typedef struct {
+    const char *name;
+    uint64_t (*run)(BenchCase *c, unsigned reps);   /* reps operaciones seguidas */
+    void (*prepare)(BenchCase *c);                  /* antes de cada muestra, fuera del tiempo (o NULL) */
+    unsigned (*max_reps)(const BenchCase *c);       /* tope de reps por muestra (NULL = sin tope) */
+    int per_board;                                  /* 0: no depende del tablero, se mide una vez */
+} Kernel;
+
+typedef struct {
+    uint64_t ops;
+    unsigned samples;
+    double mean, min, p50, p90, p99;    /* ns por operación */
+} BenchResult;
+
+static uint64_t clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NANOSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/* xorshift64*: reproducible con -s, independiente de rand() */
+static uint32_t bench_rand(uint64_t *s)
+{
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return (uint32_t)((*s * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+/* ---------- kernels ---------- */
+
+static uint64_t k_rules_validate(BenchCase *c, unsigned reps)
+{
+    const GameState *G = c->G;
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+    {
+        int gain = 0;
+        s += (uint64_t)rules_validate(G, (int)(c->cursor % G->n_players), (Dir)((c->cursor / G->n_players) & 7), &gain);
+        s += (uint64_t)gain;
+    }
+    return s;
+}
+
+static uint64_t k_rules_apply(BenchCase *c, unsigned reps)
+{
+    for (unsigned r = 0; r < reps; ++r)
+        rules_apply(c->G, 0, (Dir)c->walk[r]);
+    return c->G->P[0].score;
+}
+
+static void walk_undo(BenchCase *c)
+{
+    GameState *G = c->G;
+    for (unsigned i = c->walk_len; i-- > 0;)
+    {
+        cell_set(G, idx(G, c->walk_x[i], c->walk_y[i]), c->walk_old[i]);
+        occ_clear(G, c->walk_x[i], c->walk_y[i]);
+    }
+    G->P[0] = c->p0;
+    G->stats = c->stats;
+}
+
+static unsigned walk_reps(const BenchCase *c) { return c->walk_len; }
+
+static uint64_t k_player_can_move(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+        s += (uint64_t)player_can_move(c->G, (int)(c->cursor % c->G->n_players));
+    return s;
+}
+
+static uint64_t k_remaining_rewards(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r)
+        s += state_remaining_rewards(c->G);
+    return s;
+}
+
+static uint64_t k_greedy_choose(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+    {
+        uint8_t d = 0;
+        s += (uint64_t)bot_greedy_choose(c->G, (int)(c->cursor % c->G->n_players), &d) + d;
+    }
+    return s;
+}
+
+static uint64_t k_heuristic_choose(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+    {
+        uint8_t d = 0;
+        s += (uint64_t)bot_heuristic_choose(c->G, (int)(c->cursor % c->G->n_players), &c->hctx, &d) + d;
+    }
+    return s;
+}
+
+static uint64_t k_reward_vector(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+    {
+        const Player *p = &c->G->P[c->cursor % c->G->n_players];
+        long long vx = 0, vy = 0;
+        bot_reward_vector(c->G, (int)p->x, (int)p->y, &vx, &vy);
+        s += (uint64_t)(vx ^ vy);
+    }
+    return s;
+}
+
+static uint64_t k_free_space_window(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+    {
+        /* desde cada vecina de cada cabeza, como lo llama player2 por jugada candidata */
+        const Player *p = &c->G->P[c->cursor % c->G->n_players];
+        unsigned d = (c->cursor / c->G->n_players) & 7;
+        s += (uint64_t)bot_free_space_window(c->G, (int)p->x + DX[d], (int)p->y + DY[d], BENCH_FREE_RADIUS);
+    }
+    return s;
+}
+
+static uint64_t k_voronoi_eval(BenchCase *c, unsigned reps)
+{
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r, ++c->cursor)
+    {
+        /* territorio con la cabeza movida a una vecina, como cada candidata de player2 */
+        const GameState *G = c->G;
+        unsigned i = c->cursor % G->n_players;
+        unsigned d = (c->cursor / G->n_players) & 7;
+        long long nx = (long long)G->P[i].x + DX[d], ny = (long long)G->P[i].y + DY[d];
+        if (nx < 0 || ny < 0 || nx >= (long long)G->w || ny >= (long long)G->h)
+            continue;
+        VoronoiResult vr;
+        if (voronoi_eval(&c->hctx.vw, G, (int)i, (unsigned)nx, (unsigned)ny, BENCH_TERRITORY_HORIZON, &vr) == 0)
+            s += vr.cells[i] + vr.steps;
+    }
+    return s;
+}
+
+/* lattice para BENCH_PLACE_PLAYERS y anillos desde cada punto que cae en una celda capturada */
+static uint64_t k_placement(BenchCase *c, unsigned reps)
+{
+    static unsigned xs[BENCH_PLACE_PLAYERS], ys[BENCH_PLACE_PLAYERS];
+    const GameState *G = c->G;
+    uint64_t s = 0;
+    for (unsigned r = 0; r < reps; ++r)
+    {
+        placement_lattice(G->w, G->h, BENCH_PLACE_PLAYERS, xs, ys);
+        for (unsigned i = 0; i < BENCH_PLACE_PLAYERS; ++i)
+        {
+            unsigned x = xs[i], y = ys[i];
+            if (occ_test(G, x, y))
+                (void)placement_nearest_free(G, xs[i], ys[i], &x, &y);
+            s += x + y;
+        }
+    }
+    return s;
+}
+
+static uint64_t k_rdlock_pair(BenchCase *c, unsigned reps)
+{
+    (void)c;
+    for (unsigned r = 0; r < reps; ++r)
+    {
+        rdlock();
+        rdunlock();
+    }
+    return reps;
+}
+
+static uint64_t k_wrlock_pair(BenchCase *c, unsigned reps)
+{
+    (void)c;
+    for (unsigned r = 0; r < reps; ++r)
+    {
+        wrlock();
+        wrunlock();
+    }
+    return reps;
+}
+
+static const Kernel KERNELS[] = {
+    {"rules_validate", k_rules_validate, NULL, NULL, 1},
+    {"rules_apply", k_rules_apply, walk_undo, walk_reps, 1},
+    {"player_can_move", k_player_can_move, NULL, NULL, 1},
+    {"state_remaining_rewards", k_remaining_rewards, NULL, NULL, 1},
+    {"greedy_choose", k_greedy_choose, NULL, NULL, 1},
+    {"heuristic_choose", k_heuristic_choose, NULL, NULL, 1},
+    {"reward_vector", k_reward_vector, NULL, NULL, 1},
+    {"free_space_window", k_free_space_window, NULL, NULL, 1},
+    {"voronoi_eval", k_voronoi_eval, NULL, NULL, 1},
+    {"placement_256", k_placement, NULL, NULL, 1},
+    {"rdlock_pair", k_rdlock_pair, NULL, NULL, 0},
+    {"wrlock_pair", k_wrlock_pair, NULL, NULL, 0},
+};
+#define N_KERNELS (sizeof(KERNELS) / sizeof(KERNELS[0]))
+
+/* ---------- medición ---------- */
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, unsigned n, double q)
+{
+    return sorted[(size_t)(q * (double)(n - 1) + 0.5)];
+}
+
+/*
+ * Cada muestra es un lote de reps operaciones (reps se duplica hasta que el
+ * lote dura BENCH_BATCH_NS); se toman muestras hasta gastar budget_ms de
+ * tiempo medido. Los percentiles son sobre el ns/op de cada lote.
+ */
+static int measure(const Kernel *k, BenchCase *c, unsigned budget_ms, double *samples, BenchResult *out)
+{
+    unsigned cap = k->max_reps ? k->max_reps(c) : 0;
+    if (k->max_reps && cap == 0)
+        return -1;
+
+    unsigned reps = 1;
+    uint64_t s = 0;
+    for (;;)
+    {
+        if (k->prepare)
+            k->prepare(c);
+        uint64_t t0 = clock_ns();
+        s += k->run(c, reps);
+        uint64_t dt = clock_ns() - t0;
+        if (dt >= BENCH_BATCH_NS || (cap && reps >= cap) || reps >= (1u << 30))
+            break;
+        reps *= 2;
+        if (cap && reps > cap)
+            reps = cap;
+    }
+
+    const uint64_t budget_ns = (uint64_t)budget_ms * 1000000ull;
+    uint64_t spent = 0;
+    unsigned n = 0;
+    while (n < BENCH_MAX_SAMPLES && (n < BENCH_MIN_SAMPLES || spent < budget_ns))
+    {
+        if (k->prepare)
+            k->prepare(c);
+        uint64_t t0 = clock_ns();
+        s += k->run(c, reps);
+        uint64_t dt = clock_ns() - t0;
+        spent += dt;
+        samples[n++] = (double)dt / (double)reps;
+    }
+    /* dejar el tablero como estaba para el próximo kernel */
+    if (k->prepare)
+        k->prepare(c);
+    bench_sink += s;
+
+    qsort(samples, n, sizeof(double), cmp_double);
+    out->ops = (uint64_t)reps * n;
+    out->samples = n;
+    out->mean = (double)spent / (double)out->ops;
+    out->min = samples[0];
+    out->p50 = percentile(samples, n, 0.50);
+    out->p90 = percentile(samples, n, 0.90);
+    out->p99 = percentile(samples, n, 0.99);
+    return 0;
+}
+
+/* ---------- preparación de tableros ---------- */
+
+static int near_head(const GameState *G, unsigned x, unsigned y)
+{
+    for (unsigned i = 0; i < G->n_players; ++i)
+        if (x + 1 >= G->P[i].x && x <= G->P[i].x + 1 && y + 1 >= G->P[i].y && y <= G->P[i].y + 1)
+            return 1;
+    return 0;
+}
+
+/* captura ~pct% de las celdas al azar; las vecinas de las cabezas quedan libres para que haya jugadas */
+static void bench_fill(GameState *G, unsigned pct, uint64_t *rng)
+{
+    const uint64_t threshold = ((uint64_t)pct << 32) / 100;
+    for (unsigned y = 0; y < G->h; ++y)
+        for (unsigned x = 0; x < G->w; ++x)
+        {
+            if (bench_rand(rng) >= threshold || occ_test(G, x, y) || near_head(G, x, y))
+                continue;
+            int owner = (int)(bench_rand(rng) % G->n_players);
+            size_t i = idx(G, x, y);
+            stats_on_capture(G, owner, cell_reward(cell_get(G, i)));
+            cell_set(G, i, make_captured(owner));
+            occ_set(G, x, y);
+        }
+}
+
+/* caminata de P0 por jugadas válidas; se recorre y se deshace para dejar el tablero intacto */
+static void bench_walk(BenchCase *c)
+{
+    GameState *G = c->G;
+    c->p0 = G->P[0];
+    c->stats = G->stats;
+    c->walk_len = 0;
+    while (c->walk_len < BENCH_WALK_MAX)
+    {
+        unsigned first = c->walk_len * 3, k;
+        for (k = 0; k < 8; ++k)
+            if (rules_validate(G, 0, (Dir)((first + k) & 7), NULL))
+                break;
+        if (k == 8)
+            break;
+        unsigned d = (first + k) & 7;
+        unsigned nx = (unsigned)((int)G->P[0].x + DX[d]), ny = (unsigned)((int)G->P[0].y + DY[d]);
+        c->walk[c->walk_len] = (uint8_t)d;
+        c->walk_x[c->walk_len] = nx;
+        c->walk_y[c->walk_len] = ny;
+        c->walk_old[c->walk_len] = cell_get(G, idx(G, nx, ny));
+        c->walk_len++;
+        rules_apply(G, 0, (Dir)d);
+    }
+    walk_undo(c);
+}
+
+/* ---------- salida ---------- */
+
+static void print_row(const char *name, unsigned side, int has_board, unsigned fill, const BenchResult *r)
+{
+    char board[32] = "-";
+    if (has_board)
+        snprintf(board, sizeof(board), "%ux%u/%u%%", side, side, fill);
+    printf("%-24s %-16s %12.1f %12.1f %12.1f %12.1f %8u\n", name, board, r->mean, r->p50, r->p90, r->p99, r->samples);
+    fflush(stdout);
+}
+
+static void json_row(FILE *f, int *first, const char *name, unsigned side, int has_board, unsigned fill,
+                     const BenchResult *r)
+{
+    if (!f)
+        return;
+    fprintf(f, "%s\n    {\"kernel\": \"%s\", ", *first ? "" : ",", name);
+    if (has_board)
+        fprintf(f, "\"w\": %u, \"h\": %u, \"fill_pct\": %u, ", side, side, fill);
+    fprintf(f,
+            "\"ops\": %llu, \"samples\": %u, \"ns_per_op\": %.2f, \"min\": %.2f, \"p50\": %.2f, \"p90\": %.2f, "
+            "\"p99\": %.2f}",
+            (unsigned long long)r->ops, r->samples, r->mean, r->min, r->p50, r->p90, r->p99);
+    *first = 0;
+}
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [-w lados] [-f llenados] [-k kernels] [-b budget_ms] [-s seed] [-c int|byte] [-j salida.json]\n\n"
+            "Notas:\n"
+            "- w: lados de tablero separados por coma (default %s).\n"
+            "- f: %% de celdas capturadas separados por coma, 0..99 (default %s).\n"
+            "- k: sólo estos kernels (por nombre, separados por coma).\n"
+            "- b: tiempo medido por kernel y tablero en ms (default %d).\n"
+            "- j: además escribe los resultados en JSON.\n"
+            "Kernels:",
+            prog, DEFAULT_SIZES, DEFAULT_FILLS, DEFAULT_BUDGET_MS);
+    for (size_t i = 0; i < N_KERNELS; ++i)
+        fprintf(stderr, " %s", KERNELS[i].name);
+    fprintf(stderr, "\n");
+}
+
+static int parse_list(const char *s, unsigned *out, unsigned max_value)
+{
+    int n = 0;
+    while (*s)
+    {
+        char *end;
+        errno = 0;
+        unsigned long v = strtoul(s, &end, 10);
+        if (end == s || errno || v > max_value || n == MAX_LIST)
+            return -1;
+        out[n++] = (unsigned)v;
+        if (*end == ',')
+            end++;
+        else if (*end)
+            return -1;
+        s = end;
+    }
+    return n;
+}
+
+static int kernel_selected(const char *filter, const char *name)
+{
+    if (!filter)
+        return 1;
+    size_t len = strlen(name);
+    for (const char *p = filter; (p = strstr(p, name)) != NULL; p += len)
+        if ((p == filter || p[-1] == ',') && (p[len] == '\0' || p[len] == ','))
+            return 1;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned sides[MAX_LIST], fills[MAX_LIST];
+    int n_sides = parse_list(DEFAULT_SIZES, sides, STATE_MAX_SIDE);
+    int n_fills = parse_list(DEFAULT_FILLS, fills, 99);
+    unsigned budget_ms = DEFAULT_BUDGET_MS, seed = DEFAULT_SEED;
+    const char *filter = NULL, *json_path = NULL;
+    CellFormat fmt = CELL_FMT_INT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:f:k:b:s:c:j:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w': n_sides = parse_list(optarg, sides, STATE_MAX_SIDE); break;
+        case 'f': n_fills = parse_list(optarg, fills, 99); break;
+        case 'k': filter = optarg; break;
+        case 'b': budget_ms = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 's': seed = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'c':
+            if (strcmp(optarg, "byte") == 0)
+                fmt = CELL_FMT_BYTE;
+            else if (strcmp(optarg, "int") != 0)
+                n_sides = -1;
+            break;
+        case 'j': json_path = optarg; break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc || n_sides <= 0 || n_fills <= 0)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    for (int i = 0; i < n_sides; ++i)
+        if (sides[i] < 3)
+        {
+            fprintf(stderr, "chompbench: lado mínimo 3 (recibido %u)\n", sides[i]);
+            return 1;
+        }
+
+    double *samples = malloc(BENCH_MAX_SAMPLES * sizeof(double));
+    if (!samples)
+    {
+        perror("malloc");
+        return 1;
+    }
+    FILE *jf = NULL;
+    if (json_path)
+    {
+        jf = fopen(json_path, "w");
+        if (!jf)
+        {
+            perror(json_path);
+            free(samples);
+            return 1;
+        }
+        fprintf(jf, "{\n  \"tool\": \"chompbench\", \"players\": %d, \"cell_format\": \"%s\", \"seed\": %u, "
+                    "\"budget_ms\": %u, \"unit\": \"ns/op\",\n  \"results\": [",
+                BENCH_PLAYERS, fmt == CELL_FMT_BYTE ? "byte" : "int", seed, budget_ms);
+    }
+    int first = 1;
+    printf("%-24s %-16s %12s %12s %12s %12s %8s\n", "kernel", "tablero/lleno", "ns/op", "p50", "p90", "p99", "muestras");
+
+    /* locks: un lector o escritor sin competencia, sobre un /game_sync en un namespace propio */
+    char ns[SHM_NS_MAX];
+    snprintf(ns, sizeof(ns), "bench.%ld", (long)getpid());
+    shm_set_namespace(ns);
+    if (sync_create() == 0)
+    {
+        for (size_t k = 0; k < N_KERNELS; ++k)
+        {
+            BenchResult r;
+            if (KERNELS[k].per_board || !kernel_selected(filter, KERNELS[k].name) ||
+                measure(&KERNELS[k], NULL, budget_ms, samples, &r) != 0)
+                continue;
+            print_row(KERNELS[k].name, 0, 0, 0, &r);
+            json_row(jf, &first, KERNELS[k].name, 0, 0, 0, &r);
+        }
+        sync_destroy();
+    }
+    else
+        perror("sync_create");
+
+    int rc = 0;
+    for (int si = 0; si < n_sides && rc == 0; ++si)
+    {
+        for (int fi = 0; fi < n_fills; ++fi)
+        {
+            SimGame game;
+            if (sim_init(&game, sides[si], sides[si], BENCH_PLAYERS, fmt) != 0)
+            {
+                perror("sim_init");
+                rc = 1;
+                break;
+            }
+            sim_reset(&game, seed);
+            uint64_t rng = ((uint64_t)seed << 32) ^ ((uint64_t)sides[si] << 8) ^ fills[fi] ^ 0x9E3779B97F4A7C15ull;
+            bench_fill(game.G, fills[fi], &rng);
+
+            BenchCase c;
+            memset(&c, 0, sizeof(c));
+            c.G = game.G;
+            c.fill = fills[fi];
+            bench_walk(&c);
+            bot_heuristic_init(&c.hctx);
+
+            for (size_t k = 0; k < N_KERNELS; ++k)
+            {
+                BenchResult r;
+                if (!KERNELS[k].per_board || !kernel_selected(filter, KERNELS[k].name))
+                    continue;
+                if (measure(&KERNELS[k], &c, budget_ms, samples, &r) != 0)
+                    continue;   /* sin jugadas válidas para rules_apply */
+                print_row(KERNELS[k].name, sides[si], 1, fills[fi], &r);
+                json_row(jf, &first, KERNELS[k].name, sides[si], 1, fills[fi], &r);
+            }
+            bot_heuristic_free(&c.hctx);
+            sim_free(&game);
+        }
+    }
+
+    if (jf)
+    {
+        fprintf(jf, "\n  ]\n}\n");
+        fclose(jf);
+    }
+    free(samples);
+    return rc;
+}
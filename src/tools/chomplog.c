@@ -0,0 +1,176 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "evlog.h"
+
+#define PASS_SENTINEL 0xFF
+#define NANOSEC_PER_SEC 1000000000.0
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [-p jugador] [-l nivel] [-t] archivo.evlog [...]\n\n"
+            "Notas:\n"
+            "- sin -p: el texto que imprimía el master por stdout en cada jugada.\n"
+            "- p: sólo ese jugador, con el formato que el master anotaba en logs/player-PID.log.\n"
+            "- l: nivel máximo a mostrar: error o info (default info).\n"
+            "- t: antepone segundos desde el primer registro.\n",
+            prog);
+}
+
+/* formato de stdout del master */
+static void print_master(const EvRecord *r)
+{
+    unsigned dir = r->arg[0] & 0xFFu;
+    switch (r->kind)
+    {
+    case EV_VALID:
+        printf("[round %u] player %u VALID dir=%u gain=%u score=%u pos=(%u,%u)\n",
+               r->round, r->player, dir, r->arg[0] >> 8, r->arg[1], r->arg[2], r->arg[3]);
+        break;
+    case EV_INVALID:
+        printf("[round %u] player %u INVALID dir=%u (invalids=%u)\n", r->round, r->player, dir, r->arg[1]);
+        break;
+    case EV_PASS:
+        printf("[round %u] player %u PASS -> BLOCKED\n", r->round, r->player);
+        break;
+    case EV_BLOCKED:
+        printf("player %u BLOCKED (no moves)\n", r->player);
+        break;
+    case EV_TIMEOUT:
+        printf("[round %u] player %u TIMEOUT\n", r->round, r->player);
+        break;
+    case EV_EOF:
+        printf("player %u EOF\n", r->player);
+        break;
+    case EV_READ_ERROR:
+        printf("player %u read: %s\n", r->player, strerror((int)r->arg[0]));
+        break;
+    case EV_PLAYER_MOVE:
+        printf("player %u move dir=%u think_us=%u\n", r->player, dir, r->arg[1]);
+        break;
+    case EV_DROPPED:
+        printf("evlog: %u registros descartados (anillo lleno)\n", r->arg[0]);
+        break;
+    default:
+        printf("evlog: registro desconocido kind=%u\n", r->kind);
+        break;
+    }
+}
+
+/* formato de logs/player-PID.log: lo que el master anotaba por jugador */
+static void print_player(const EvRecord *r)
+{
+    switch (r->kind)
+    {
+    case EV_VALID:
+    case EV_INVALID:
+        printf("mv=%u\n", r->arg[0] & 0xFFu);
+        break;
+    case EV_PASS:
+        printf("mv=%u\n", PASS_SENTINEL);
+        break;
+    case EV_TIMEOUT:
+        printf("TIMEOUT\n");
+        break;
+    case EV_EOF:
+        printf("EOF\n");
+        break;
+    case EV_READ_ERROR:
+        printf("ERROR read errno=%u\n", r->arg[0]);
+        break;
+    default:
+        print_master(r);
+        break;
+    }
+}
+
+static int decode(const char *path, int only_player, int max_level, int stamps)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    EvFileHeader h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, EVLOG_MAGIC, sizeof(h.magic)) != 0)
+    {
+        fprintf(stderr, "%s: no es un log de eventos\n", path);
+        fclose(f);
+        return -1;
+    }
+    if (h.version != EVLOG_VERSION || h.record_size != sizeof(EvRecord))
+    {
+        fprintf(stderr, "%s: versión %u / registro de %u bytes no soportados\n", path, h.version, h.record_size);
+        fclose(f);
+        return -1;
+    }
+
+    EvRecord r;
+    uint64_t t0 = 0;
+    int first = 1;
+    while (fread(&r, sizeof(r), 1, f) == 1)
+    {
+        if (first)
+        {
+            t0 = r.t_ns;
+            first = 0;
+        }
+        if ((int)r.level > max_level)
+            continue;
+        /* los descartes no son de un jugador: se muestran siempre */
+        if (only_player >= 0 && r.kind != EV_DROPPED && r.player != (unsigned)only_player)
+            continue;
+        if (stamps)
+            printf("%.6f ", (double)(r.t_ns - t0) / NANOSEC_PER_SEC);
+        if (only_player >= 0)
+            print_player(&r);
+        else
+            print_master(&r);
+    }
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int only_player = -1, max_level = EVLOG_INFO, stamps = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:l:t")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            only_player = atoi(optarg);
+            break;
+        case 'l':
+            if (evlog_parse_level(optarg, &max_level) != 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 't':
+            stamps = 1;
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind >= argc)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    int rc = 0;
+    for (int i = optind; i < argc; ++i)
+        if (decode(argv[i], only_player, max_level, stamps) != 0)
+            rc = 1;
+    return rc;
+}
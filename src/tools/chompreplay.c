@@ -0,0 +1,212 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "replay.h"
+
+#define NANOSEC_PER_MSEC 1000000.0
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [-m jugada [-b]] [-v] archivo.replay\n\n"
+            "Notas:\n"
+            "- sin opciones: resumen (tablero, semilla, jugadas, keyframes, bytes por jugada).\n"
+            "- m: reconstruye el estado tras esa jugada y muestra los jugadores.\n"
+            "- b: con -m, imprime además el tablero (sólo tableros chicos).\n"
+            "- v: verifica el espaciado de los keyframes y cada uno, más una jugada entre cada par,\n"
+            "     contra la reproducción desde el inicio.\n",
+            prog);
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / NANOSEC_PER_MSEC;
+}
+
+static void print_summary(const char *path, const ReplayReader *r)
+{
+    const ReplayHeader *h = replay_header(r);
+    struct stat st;
+    long long bytes = stat(path, &st) == 0 ? (long long)st.st_size : -1;
+    uint64_t moves = replay_moves(r);
+    printf("tablero %ux%u  jugadores %u  semilla %u  formato %s\n", h->w, h->h, h->n_players, h->seed,
+           h->cell_format == CELL_FMT_BYTE ? "byte" : "int");
+    for (unsigned i = 0; i < h->n_players; ++i)
+        printf("  P%c %-16.*s inicio=(%u,%u)\n", 'A' + i, NAME_LEN, h->names[i], h->start_x[i], h->start_y[i]);
+    printf("jugadas %llu  keyframes %u  archivo %lld bytes", (unsigned long long)moves, replay_keyframes(r), bytes);
+    if (moves > 0 && bytes > (long long)sizeof(*h))
+        printf("  (%.2f bytes/jugada sin cabecera)", (double)(bytes - (long long)sizeof(*h)) / (double)moves);
+    printf("\n");
+}
+
+static void print_state(const GameState *G, int board)
+{
+    for (unsigned i = 0; i < G->n_players; ++i)
+    {
+        const Player *p = &G->P[i];
+        printf("P%c  score=%u  valids=%u  invalids=%u  timeouts=%u  pos=(%u,%u)%s\n", 'A' + i, p->score, p->valids,
+               p->invalids, p->timeouts, p->x, p->y, p->blocked ? " [BLOCKED]" : "");
+    }
+    if (!board)
+        return;
+    for (unsigned y = 0; y < G->h; ++y)
+    {
+        for (unsigned x = 0; x < G->w; ++x)
+        {
+            int v = cell_get(G, idx(G, x, y));
+            int o = cell_owner(v);
+            putchar(o >= 0 ? 'A' + o : '0' + v);
+        }
+        putchar('\n');
+    }
+}
+
+/* compara lo que se reconstruye igual desde keyframe o desde el inicio */
+static int same_state(const GameState *a, const GameState *b)
+{
+    size_t cells = (size_t)a->w * a->h;
+    if (memcmp(&a->stats, &b->stats, sizeof(a->stats)) != 0)
+        return 0;
+    if (memcmp(a->board, b->board, cells * cell_bytes(a->cell_format)) != 0)
+        return 0;
+    for (unsigned i = 0; i < a->n_players; ++i)
+    {
+        const Player *p = &a->P[i], *q = &b->P[i];
+        if (p->score != q->score || p->valids != q->valids || p->invalids != q->invalids ||
+            p->timeouts != q->timeouts || p->x != q->x || p->y != q->y || p->blocked != q->blocked)
+            return 0;
+    }
+    return 1;
+}
+
+/* seek con keyframes contra reproducción desde el inicio, en una jugada cualquiera */
+static int check_move(ReplayReader *r, uint64_t m, GameState *A, GameState *B)
+{
+    int64_t ka = replay_seek(r, m, 1, A);
+    int64_t kb = replay_seek(r, m, 0, B);
+    return ka >= 0 && ka == kb && same_state(A, B);
+}
+
+static int verify(ReplayReader *r, GameState *A, GameState *B)
+{
+    unsigned n = replay_keyframes(r);
+    uint32_t interval = replay_header(r)->key_interval;
+    int bad = 0;
+    uint64_t prev = 0;
+    for (unsigned k = 0; k < n; ++k)
+    {
+        uint64_t m = replay_keyframe_move(r, k);
+        /* el writer los espacia exactamente key_interval jugadas: el seek queda acotado */
+        if (m - prev != interval)
+        {
+            printf("keyframe %u  jugada %llu  a %llu jugadas del anterior (intervalo %u)\n", k,
+                   (unsigned long long)m, (unsigned long long)(m - prev), interval);
+            bad = 1;
+        }
+        /* a mitad de tramo: búsqueda del keyframe anterior más las jugadas que faltan */
+        uint64_t mid = prev + (m - prev) / 2;
+        int mid_ok = check_move(r, mid, A, B);
+        printf("tramo  jugada %llu  %s\n", (unsigned long long)mid, mid_ok ? "OK" : "DIFIERE");
+        if (!mid_ok)
+            bad = 1;
+        prev = m;
+        double t0 = now_ms();
+        int64_t ka = replay_seek(r, m, 1, A);
+        double t1 = now_ms();
+        int64_t kb = replay_seek(r, m, 0, B);
+        double t2 = now_ms();
+        int ok = ka >= 0 && ka == kb && same_state(A, B);
+        printf("keyframe %u  jugada %llu  %s  (seek %.2f ms, desde el inicio %.2f ms)\n", k, (unsigned long long)m,
+               ok ? "OK" : "DIFIERE", t1 - t0, t2 - t1);
+        if (!ok)
+            bad = 1;
+    }
+    /* también el final, que suele caer entre keyframes */
+    uint64_t end = replay_moves(r);
+    int ok = check_move(r, end, A, B);
+    printf("final  jugada %llu  %s\n", (unsigned long long)end, ok ? "OK" : "DIFIERE");
+    return bad || !ok ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    long long move = -1;
+    int board = 0, check = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:bv")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm':
+            move = atoll(optarg);
+            break;
+        case 'b':
+            board = 1;
+            break;
+        case 'v':
+            check = 1;
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind + 1 != argc || move < -1)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    ReplayReader *r = replay_open(argv[optind]);
+    if (!r)
+        return 1;
+    const ReplayHeader *h = replay_header(r);
+
+    int rc = 0;
+    if (move < 0 && !check)
+        print_summary(argv[optind], r);
+    else
+    {
+        GameState *A = state_alloc(h->w, h->h, (CellFormat)h->cell_format);
+        GameState *B = check ? state_alloc(h->w, h->h, (CellFormat)h->cell_format) : NULL;
+        if (!A || (check && !B))
+        {
+            perror("state_alloc");
+            rc = 1;
+        }
+        else
+        {
+            if (move >= 0)
+            {
+                double t0 = now_ms();
+                int64_t got = replay_seek(r, (uint64_t)move, 1, A);
+                double t1 = now_ms();
+                if (got < 0)
+                {
+                    fprintf(stderr, "%s: replay dañado\n", argv[optind]);
+                    rc = 1;
+                }
+                else
+                {
+                    printf("jugada %lld de %llu (%.2f ms)\n", (long long)got, (unsigned long long)replay_moves(r),
+                           t1 - t0);
+                    print_state(A, board);
+                }
+            }
+            if (check && verify(r, A, B) != 0)
+                rc = 1;
+        }
+        free(A);
+        free(B);
+    }
+    replay_free(r);
+    return rc;
+}
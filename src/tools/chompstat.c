@@ -0,0 +1,163 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "shm.h"
+#include "stats.h"
+
+#define DEFAULT_INTERVAL_MS 1000
+#define NANOSEC_PER_USEC 1000.0
+#define MAX_LISTED_NS 16
+
+static const char *METRIC_NAMES[STAT_METRICS] = {"turno->jugada", "aplicar", "render"};
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [-N namespace] [-i intervalo_ms] [-n veces] [-1]\n\n"
+            "Notas:\n"
+            "- lee /game_stats de la partida en curso sin frenar al master.\n"
+            "- N: partida a leer (default CHOMP_SHM_NS; si no está y hay una sola partida, ésa).\n"
+            "- i: cada cuánto se imprime (default %d ms).\n"
+            "- n: cantidad de impresiones (default: hasta que termine la partida).\n"
+            "- 1: una sola impresión (igual que -n 1).\n"
+            "Métricas (microsegundos, percentiles acumulados desde el inicio):\n"
+            "- turno->jugada: desde que el master da el turno hasta que recibe el movimiento.\n"
+            "- aplicar: lock de escritura, validar y aplicar la jugada.\n"
+            "- render: espera a la view (publicar el frame con -F).\n",
+            prog, DEFAULT_INTERVAL_MS);
+}
+
+static void sleep_ms(unsigned ms)
+{
+    struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L};
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+        ;
+}
+
+/* elige la partida: -N, CHOMP_SHM_NS o la única que haya en /dev/shm */
+static int select_namespace(const char *ns)
+{
+    if (ns || (ns = getenv("CHOMP_SHM_NS")) != NULL)
+    {
+        if (shm_set_namespace(ns) == 0)
+            return 0;
+        fprintf(stderr, "chompstat: namespace inválido '%s'\n", ns);
+        return -1;
+    }
+    char found[MAX_LISTED_NS][SHM_NS_MAX];
+    int n = shm_list_namespaces(SHM_GAME_STATS, found, MAX_LISTED_NS);
+    if (n == 1)
+        return shm_set_namespace(found[0]);
+    if (n > 1)
+    {
+        fprintf(stderr, "chompstat: hay %d partidas en curso, elegir una con -N:\n", n);
+        for (int i = 0; i < n && i < MAX_LISTED_NS; ++i)
+            fprintf(stderr, "  %s\n", found[i]);
+        return -1;
+    }
+    /* ninguna con namespace: probar el nombre sin namespace */
+    return 0;
+}
+
+static void print_row(const char *who, const char *metric, const StatsSnapshot *s)
+{
+    printf("%-18s %-14s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", who, metric, (unsigned long long)s->count,
+           (double)stats_percentile(s, 0.50) / NANOSEC_PER_USEC, (double)stats_percentile(s, 0.90) / NANOSEC_PER_USEC,
+           (double)stats_percentile(s, 0.99) / NANOSEC_PER_USEC, (double)s->max_ns / NANOSEC_PER_USEC,
+           (double)s->sum_ns / (double)s->count / NANOSEC_PER_USEC);
+}
+
+static void print_stats(const StatsShm *st, StatsSnapshot *snap)
+{
+    unsigned n = st->n_players > MAX_PLAYERS ? MAX_PLAYERS : st->n_players;
+    printf("ronda %u%s\n", atomic_load_explicit(&st->rounds, memory_order_relaxed),
+           atomic_load_explicit(&st->game_over, memory_order_acquire) ? "  (terminada)" : "");
+    /* "métrica" ocupa un byte más que columnas */
+    printf("%-18s %-15s %10s %10s %10s %10s %10s %10s\n", "jugador", "métrica", "n", "p50", "p90", "p99", "max",
+           "media");
+    for (unsigned row = 0; row < STATS_ROWS; ++row)
+    {
+        if (row < STATS_ROW_MASTER && row >= n)
+            continue;
+        char who[32];
+        if (row == STATS_ROW_MASTER)
+            snprintf(who, sizeof(who), "fin de ronda");
+        else
+            snprintf(who, sizeof(who), "P%c %.*s", 'A' + row, NAME_LEN, st->names[row]);
+        for (unsigned m = 0; m < STAT_METRICS; ++m)
+        {
+            stats_snapshot(&st->hist[row][m], snap);
+            if (snap->count > 0)
+                print_row(who, METRIC_NAMES[m], snap);
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned interval_ms = DEFAULT_INTERVAL_MS;
+    long times = 0;
+    const char *ns = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "N:i:n:1")) != -1)
+    {
+        switch (opt)
+        {
+        case 'N': ns = optarg; break;
+        case 'i': interval_ms = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'n': times = atol(optarg); break;
+        case '1': times = 1; break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc || times < 0)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (select_namespace(ns) != 0)
+        return 1;
+    const StatsShm *st = stats_attach();
+    if (!st)
+    {
+        if (errno == ENOENT)
+            fprintf(stderr, "chompstat: no hay partida en curso (%s)\n", SHM_GAME_STATS);
+        else
+            fprintf(stderr, "chompstat: %s: %s\n", SHM_GAME_STATS, strerror(errno));
+        return 1;
+    }
+    /* la copia de un histograma ocupa ~10 KB: en el heap, una sola vez */
+    StatsSnapshot *snap = malloc(sizeof(*snap));
+    if (!snap)
+    {
+        perror("malloc");
+        stats_detach(st);
+        return 1;
+    }
+
+    for (long k = 0; times == 0 || k < times; ++k)
+    {
+        if (k > 0)
+            sleep_ms(interval_ms);
+        /* el master marca game_over al final: esa es la última impresión */
+        int over = (int)atomic_load_explicit(&st->game_over, memory_order_acquire);
+        print_stats(st, snap);
+        if (over)
+            break;
+    }
+
+    free(snap);
+    stats_detach(st);
+    return 0;
+}
@@ -0,0 +1,715 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "state.h"
+
+#define DEFAULT_MASTER "./master"
+#define DEFAULT_SIZES "10"
+#define DEFAULT_SEEDS "1-10"
+#define DEFAULT_WORKDIR "logs/tournament"
+#define SHM_TAG "tour"
+#define THREADS_ENV "CHOMP_SEARCH_THREADS"
+#define MAX_SIZES 32
+#define MAX_SEEDS 1000000u
+#define MAX_OUTPUT (64 * 1024)      /* salida de un master: ranking y algunas líneas de estado */
+#define PROGRESS_MS 200
+#define NANOSEC_PER_MS 1000000ull
+
+/**
+ * @brief Una partida del torneo: tablero, semilla y bots por asiento (índices del roster).
+ */
+typedef struct {
+    unsigned w, h;
+    unsigned seed;
+    unsigned char seat[MAX_PLAYERS];
+} Match;
+
+/**
+ * @brief Resultado de un asiento, tal como lo imprime print_ranking del master.
+ */
+typedef struct {
+    unsigned rank;              /* 1 = primero */
+    unsigned score, valids, invalids, timeouts;
+    int blocked;
+} SeatResult;
+
+typedef struct {
+    int status;                 /* 0 = pendiente, 1 = ok, -1 = falló */
+    int rounds;
+    SeatResult seat[MAX_PLAYERS];
+} MatchResult;
+
+/** @brief Master en curso: su salida se acumula hasta EOF. */
+typedef struct {
+    pid_t pid;
+    int fd;
+    size_t match;
+    char *out;
+    size_t len;
+} Worker;
+
+typedef struct {
+    unsigned matches;
+    double wins;                /* empates en el primer puesto reparten la victoria */
+    unsigned long long score, rank_sum, invalids, timeouts;
+} BotTotals;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void on_sigint(int sig)
+{
+    (void)sig;
+    interrupted = 1;
+}
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [-w tamaños] [-s semillas] [-k por_partida] [-j workers] [-t timeout_s] [-T ms]\n"
+            "          [-m ./master] [-o resultados.csv] [-L dir] -p bot [bot ...]\n\n"
+            "Notas:\n"
+            "- w: tableros separados por coma, N o WxH (default %s).\n"
+            "- s: semillas, lista de números o rangos a-b (default %s).\n"
+            "- k: jugadores por partida (default: todo el roster, hasta %d). Se juega cada\n"
+            "     combinación de k bots en cada rotación de asientos, con cada tablero y semilla.\n"
+            "- j: partidas simultáneas (default: CPUs disponibles). Cada partida ocupa ~1 CPU\n"
+            "     porque los jugadores se turnan; %s se reparte entre los workers si no está.\n"
+            "- t, T: se pasan al master (timeout de ronda y presupuesto por jugada).\n"
+            "- o: una fila por asiento, en el orden de las partidas: no depende de -j.\n"
+            "- L: directorio de trabajo de los masters (logs de los jugadores; default %s).\n"
+            "- p: bots del roster ('player', 'player2' o 'player3', con su ruta).\n",
+            prog, DEFAULT_SIZES, DEFAULT_SEEDS, MAX_PLAYERS, THREADS_ENV, DEFAULT_WORKDIR);
+}
+
+static uint64_t clock_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec) / NANOSEC_PER_MS;
+}
+
+static unsigned cpu_count(void)
+{
+    cpu_set_t set;
+    long cpus = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        cpus = CPU_COUNT(&set);
+    if (cpus <= 0)
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (unsigned)cpus : 1;
+}
+
+/* "10,20x30" -> (10,10), (20,30) */
+static int parse_sizes(const char *s, unsigned w[], unsigned h[])
+{
+    int n = 0;
+    while (*s)
+    {
+        char *end;
+        unsigned long a = strtoul(s, &end, 10), b = a;
+        if (end == s)
+            return -1;
+        if (*end == 'x')
+        {
+            const char *p = end + 1;
+            b = strtoul(p, &end, 10);
+            if (end == p)
+                return -1;
+        }
+        if (a < 10 || b < 10 || a > STATE_MAX_SIDE || b > STATE_MAX_SIDE || n == MAX_SIZES)
+            return -1;
+        w[n] = (unsigned)a;
+        h[n++] = (unsigned)b;
+        if (*end == ',')
+            end++;
+        else if (*end)
+            return -1;
+        s = end;
+    }
+    return n;
+}
+
+/* "1-100,200" -> 1..100, 200; devuelve la cantidad (en *out, malloc) o -1 */
+static long parse_seeds(const char *s, unsigned **out)
+{
+    size_t n = 0, cap = 64;
+    unsigned *v = malloc(cap * sizeof(*v));
+    if (!v)
+        return -1;
+    while (*s)
+    {
+        char *end;
+        errno = 0;
+        unsigned long a = strtoul(s, &end, 10), b = a;
+        if (end == s || errno || a > UINT_MAX)
+            goto bad;
+        if (*end == '-')
+        {
+            const char *p = end + 1;
+            b = strtoul(p, &end, 10);
+            if (end == p || errno || b > UINT_MAX || b < a)
+                goto bad;
+        }
+        if (b - a >= MAX_SEEDS - n)
+            goto bad;
+        for (unsigned long x = a; x <= b; ++x)
+        {
+            if (n == cap)
+            {
+                unsigned *nv = realloc(v, 2 * cap * sizeof(*v));
+                if (!nv)
+                    goto bad;
+                v = nv;
+                cap *= 2;
+            }
+            v[n++] = (unsigned)x;
+        }
+        if (*end == ',')
+            end++;
+        else if (*end)
+            goto bad;
+        s = end;
+    }
+    *out = v;
+    return (long)n;
+bad:
+    free(v);
+    return -1;
+}
+
+/* siguiente combinación de k en n (orden lexicográfico); 0 al terminar */
+static int next_combination(unsigned char c[], unsigned k, unsigned n)
+{
+    int i = (int)k - 1;
+    while (i >= 0 && c[i] == n - k + (unsigned)i)
+        i--;
+    if (i < 0)
+        return 0;
+    c[i]++;
+    for (unsigned j = (unsigned)i + 1; j < k; ++j)
+        c[j] = (unsigned char)(c[j - 1] + 1);
+    return 1;
+}
+
+/* orden fijo: tablero, semilla, combinación, rotación; el resultado de la partida i no depende de -j */
+static Match *build_schedule(const unsigned w[], const unsigned h[], int n_sizes, const unsigned *seeds,
+                             long n_seeds, unsigned roster, unsigned k, size_t *out_n)
+{
+    size_t combos = 0;
+    unsigned char c[MAX_PLAYERS];
+    for (unsigned i = 0; i < k; ++i)
+        c[i] = (unsigned char)i;
+    do
+        combos++;
+    while (next_combination(c, k, roster));
+
+    size_t total = (size_t)n_sizes * (size_t)n_seeds * combos * k;
+    Match *m = malloc(total * sizeof(*m));
+    if (!m)
+        return NULL;
+    size_t idx = 0;
+    for (int si = 0; si < n_sizes; ++si)
+        for (long sd = 0; sd < n_seeds; ++sd)
+        {
+            for (unsigned i = 0; i < k; ++i)
+                c[i] = (unsigned char)i;
+            do
+                for (unsigned r = 0; r < k; ++r)
+                {
+                    Match *x = &m[idx++];
+                    x->w = w[si];
+                    x->h = h[si];
+                    x->seed = seeds[sd];
+                    for (unsigned s = 0; s < k; ++s)
+                        x->seat[s] = c[(s + r) % k];
+                }
+            while (next_combination(c, k, roster));
+        }
+    *out_n = total;
+    return m;
+}
+
+/* última línea no vacía de la salida del master, para explicar un fallo */
+static void last_line(const char *out, size_t len, char *dst, size_t cap)
+{
+    while (len > 0 && out[len - 1] == '\n')
+        len--;
+    size_t start = len;
+    while (start > 0 && out[start - 1] != '\n')
+        start--;
+    snprintf(dst, cap, "%.*s", (int)(len - start), out + start);
+}
+
+/* extrae del texto del master las líneas "#1  PB  score=..." y "done after N rounds" */
+static int parse_ranking(char *out, unsigned k, MatchResult *res)
+{
+    unsigned seen = 0;
+    res->rounds = -1;
+    for (char *line = strtok(out, "\n"); line; line = strtok(NULL, "\n"))
+    {
+        unsigned rank, score, valids, invalids, timeouts;
+        char who;
+        int rounds;
+        if (sscanf(line, "done after %d rounds", &rounds) == 1)
+            res->rounds = rounds;
+        else if (sscanf(line, "#%u P%c score=%u valids=%u invalids=%u timeouts=%u", &rank, &who, &score,
+                        &valids, &invalids, &timeouts) == 6)
+        {
+            unsigned s = (unsigned)(who - 'A');
+            if (s >= k || (seen & (1u << s)))
+                return -1;
+            seen |= 1u << s;
+            res->seat[s] = (SeatResult){rank, score, valids, invalids, timeouts, strstr(line, "[BLOCKED]") != NULL};
+        }
+    }
+    return seen == (1u << k) - 1 && res->rounds >= 0 ? 0 : -1;
+}
+
+static pid_t spawn_master(const char *master, char *const bots[], const Match *m, unsigned k,
+                          const char *timeout_s, const char *turn_ms, const char *workdir, int *out_fd)
+{
+    int p[2];
+    if (pipe2(p, O_CLOEXEC) != 0)
+        return -1;
+    char wbuf[16], hbuf[16], sbuf[16];
+    snprintf(wbuf, sizeof(wbuf), "%u", m->w);
+    snprintf(hbuf, sizeof(hbuf), "%u", m->h);
+    snprintf(sbuf, sizeof(sbuf), "%u", m->seed);
+    const char *argv[24 + MAX_PLAYERS];
+    int a = 0;
+    argv[a++] = master;
+    argv[a++] = "-w"; argv[a++] = wbuf;
+    argv[a++] = "-h"; argv[a++] = hbuf;
+    argv[a++] = "-s"; argv[a++] = sbuf;
+    argv[a++] = "-d"; argv[a++] = "0";
+    argv[a++] = "-l"; argv[a++] = "off";
+    argv[a++] = "-R"; argv[a++] = "off";
+    argv[a++] = "-N"; argv[a++] = SHM_TAG;
+    if (timeout_s)
+    {
+        argv[a++] = "-t";
+        argv[a++] = timeout_s;
+    }
+    if (turn_ms)
+    {
+        argv[a++] = "-T";
+        argv[a++] = turn_ms;
+    }
+    argv[a++] = "-p";
+    for (unsigned s = 0; s < k; ++s)
+        argv[a++] = bots[m->seat[s]];
+    argv[a] = NULL;
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(p[0]);
+        close(p[1]);
+        return -1;
+    }
+    if (pid == 0)
+    {
+        /* si el torneo muere, el master recibe SIGTERM y termina su partida limpiando las shm */
+        (void)prctl(PR_SET_PDEATHSIG, SIGTERM);
+        signal(SIGINT, SIG_DFL);
+        if (dup2(p[1], STDOUT_FILENO) == -1 || dup2(p[1], STDERR_FILENO) == -1 || chdir(workdir) != 0)
+            _exit(126);
+        execv(master, (char *const *)argv);
+        _exit(127);
+    }
+    close(p[1]);
+    *out_fd = p[0];
+    return pid;
+}
+
+/* lee lo disponible; 1 = EOF */
+static int worker_read(Worker *wk)
+{
+    char buf[4096];
+    ssize_t r = read(wk->fd, buf, sizeof(buf));
+    if (r < 0)
+        return errno == EINTR || errno == EAGAIN ? 0 : 1;
+    if (r == 0)
+        return 1;
+    /* lo que pase de MAX_OUTPUT se descarta: el ranking llega al final, se conserva la cola */
+    if (wk->len + (size_t)r > MAX_OUTPUT)
+    {
+        size_t drop = wk->len + (size_t)r - MAX_OUTPUT;
+        if (drop > wk->len)
+            drop = wk->len;
+        memmove(wk->out, wk->out + drop, wk->len - drop);
+        wk->len -= drop;
+    }
+    size_t take = (size_t)r > MAX_OUTPUT ? MAX_OUTPUT : (size_t)r;
+    memcpy(wk->out + wk->len, buf + (size_t)r - take, take);
+    wk->len += take;
+    return 0;
+}
+
+static void print_progress(size_t done, size_t total, unsigned failed, unsigned running, uint64_t t0, int final)
+{
+    double secs = (double)(clock_ms() - t0) / 1000.0;
+    double rate = secs > 0 ? (double)done / secs : 0;
+    double eta = rate > 0 ? (double)(total - done) / rate : 0;
+    fprintf(stderr, "%s[%zu/%zu] %.1f partidas/s, %u corriendo, %u fallidas, faltan ~%.0fs%s",
+            isatty(STDERR_FILENO) ? "\r" : "", done, total, rate, running, failed, eta,
+            final || !isatty(STDERR_FILENO) ? "\n" : "   ");
+}
+
+static void write_csv_rows(FILE *csv, size_t i, const Match *m, const MatchResult *r, unsigned k, char *const bots[])
+{
+    for (unsigned s = 0; s < k; ++s)
+    {
+        const SeatResult *x = &r->seat[s];
+        if (r->status > 0)
+            fprintf(csv, "%zu,%u,%u,%u,%u,%s,ok,%d,%u,%u,%u,%u,%u,%d\n", i, m->seed, m->w, m->h, s, bots[m->seat[s]],
+                    r->rounds, x->rank, x->score, x->valids, x->invalids, x->timeouts, x->blocked);
+        else
+            fprintf(csv, "%zu,%u,%u,%u,%u,%s,error,,,,,,,\n", i, m->seed, m->w, m->h, s, bots[m->seat[s]]);
+    }
+}
+
+static void add_totals(BotTotals t[], const Match *m, const MatchResult *r, unsigned k)
+{
+    if (r->status <= 0)
+        return;
+    unsigned top = 0, ties = 0;
+    for (unsigned s = 0; s < k; ++s)
+        if (r->seat[s].score > top)
+            top = r->seat[s].score;
+    for (unsigned s = 0; s < k; ++s)
+        ties += r->seat[s].score == top;
+    for (unsigned s = 0; s < k; ++s)
+    {
+        BotTotals *b = &t[m->seat[s]];
+        b->matches++;
+        b->score += r->seat[s].score;
+        b->rank_sum += r->seat[s].rank;
+        b->invalids += r->seat[s].invalids;
+        b->timeouts += r->seat[s].timeouts;
+        if (r->seat[s].score == top)
+            b->wins += 1.0 / ties;
+    }
+}
+
+/* borra los logs vacíos de los jugadores; los que tienen algo quedan para diagnosticar.
+   Devuelve cuántos quedaron. */
+static unsigned prune_logs(const char *workdir)
+{
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s/logs", workdir);
+    DIR *d = opendir(dir);
+    if (!d)
+        return 0;
+    unsigned kept = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL)
+    {
+        struct stat st;
+        if (e->d_name[0] == '.' || fstatat(dirfd(d), e->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode))
+            continue;
+        if (st.st_size == 0)
+            (void)unlinkat(dirfd(d), e->d_name, 0);
+        else
+            kept++;
+    }
+    closedir(d);
+    return kept;
+}
+
+static int make_dirs(const char *path)
+{
+    char buf[PATH_MAX];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char *p = buf + 1; *p; ++p)
+        if (*p == '/')
+        {
+            *p = '\0';
+            if (mkdir(buf, 0755) != 0 && errno != EEXIST)
+                return -1;
+            *p = '/';
+        }
+    return mkdir(buf, 0755) != 0 && errno != EEXIST ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned sw[MAX_SIZES], sh[MAX_SIZES];
+    int n_sizes = parse_sizes(DEFAULT_SIZES, sw, sh);
+    const char *seed_spec = DEFAULT_SEEDS, *master = DEFAULT_MASTER, *csv_path = NULL, *workdir = DEFAULT_WORKDIR;
+    const char *timeout_s = NULL, *turn_ms = NULL;
+    unsigned k = 0, workers = 0;
+    char *names[MAX_PLAYERS];   /* como se pasaron con -p (CSV y resumen) */
+    char *bots[MAX_PLAYERS];    /* rutas absolutas para el master */
+    unsigned roster = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:s:k:j:t:T:m:o:L:p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w': n_sizes = parse_sizes(optarg, sw, sh); break;
+        case 's': seed_spec = optarg; break;
+        case 'k': k = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'j': workers = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 't': timeout_s = optarg; break;
+        case 'T': turn_ms = optarg; break;
+        case 'm': master = optarg; break;
+        case 'o': csv_path = optarg; break;
+        case 'L': workdir = optarg; break;
+        case 'p':
+            /* Consumir todos los argumentos no-opción que siguen a -p */
+            optind--;
+            while (optind < argc && argv[optind][0] != '-')
+            {
+                if (roster >= MAX_PLAYERS)
+                {
+                    fprintf(stderr, "tournament: máximo %d bots en el roster\n", MAX_PLAYERS);
+                    return 1;
+                }
+                names[roster++] = argv[optind++];
+            }
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (k == 0)
+        k = roster;
+    if (roster == 0 || n_sizes <= 0 || k > roster || optind != argc)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    unsigned *seeds = NULL;
+    long n_seeds = parse_seeds(seed_spec, &seeds);
+    if (n_seeds <= 0)
+    {
+        fprintf(stderr, "tournament: semillas inválidas '%s'\n", seed_spec);
+        return 1;
+    }
+
+    /* el master corre dentro de workdir: rutas absolutas para él y los bots */
+    char master_abs[PATH_MAX];
+    if (!realpath(master, master_abs))
+    {
+        perror(master);
+        return 1;
+    }
+    for (unsigned b = 0; b < roster; ++b)
+    {
+        char *abs = realpath(names[b], NULL);
+        if (!abs)
+        {
+            perror(names[b]);
+            return 1;
+        }
+        bots[b] = abs;
+    }
+    if (make_dirs(workdir) != 0)
+    {
+        perror(workdir);
+        return 1;
+    }
+
+    size_t total = 0;
+    Match *matches = build_schedule(sw, sh, n_sizes, seeds, n_seeds, roster, k, &total);
+    MatchResult *results = calloc(total, sizeof(*results));
+    unsigned cpus = cpu_count();
+    if (workers == 0)
+        workers = cpus;
+    if (workers > total)
+        workers = (unsigned)total;
+    Worker *pool = calloc(workers, sizeof(*pool));
+    if (!matches || !results || !pool)
+    {
+        perror("malloc");
+        return 1;
+    }
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        pool[i].pid = -1;
+        pool[i].out = malloc(MAX_OUTPUT + 1);
+        if (!pool[i].out)
+        {
+            perror("malloc");
+            return 1;
+        }
+    }
+    /* player3 reparte sus hilos entre las CPUs; sin esto cada partida las usaría todas */
+    if (!getenv(THREADS_ENV))
+    {
+        char tbuf[16];
+        snprintf(tbuf, sizeof(tbuf), "%u", cpus / workers > 0 ? cpus / workers : 1);
+        setenv(THREADS_ENV, tbuf, 1);
+    }
+
+    FILE *csv = NULL;
+    if (csv_path)
+    {
+        csv = fopen(csv_path, "w");
+        if (!csv)
+        {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "match,seed,w,h,seat,bot,status,rounds,rank,score,valids,invalids,timeouts,blocked\n");
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_sigint;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    fprintf(stderr, "tournament: %zu partidas (%d tableros x %ld semillas, %u por partida), %u workers\n", total,
+            n_sizes, n_seeds, k, workers);
+    BotTotals totals[MAX_PLAYERS] = {{0}};
+    size_t next = 0, done = 0, flushed = 0, last_decile = 0;
+    unsigned running = 0, failed = 0;
+    uint64_t t0 = clock_ms(), last_progress = 0;
+    struct pollfd *pfd = calloc(workers, sizeof(*pfd));
+    unsigned *idx = calloc(workers, sizeof(*idx));
+    if (!pfd || !idx)
+    {
+        perror("calloc");
+        return 1;
+    }
+
+    int stopping = 0;
+    while ((next < total && !interrupted) || running > 0)
+    {
+        /* Ctrl-C o SIGTERM: cortar las partidas en curso (el master limpia sus shm al recibirla) */
+        if (interrupted && !stopping)
+        {
+            for (unsigned i = 0; i < workers; ++i)
+                if (pool[i].pid > 0)
+                    kill(pool[i].pid, SIGTERM);
+            stopping = 1;
+        }
+        for (unsigned i = 0; i < workers && next < total && !interrupted; ++i)
+            if (pool[i].pid < 0)
+            {
+                pool[i].pid = spawn_master(master_abs, bots, &matches[next], k, timeout_s, turn_ms, workdir,
+                                           &pool[i].fd);
+                if (pool[i].pid < 0)
+                {
+                    perror("fork");
+                    interrupted = 1;
+                    break;
+                }
+                pool[i].match = next++;
+                pool[i].len = 0;
+                running++;
+            }
+
+        nfds_t n = 0;
+        for (unsigned i = 0; i < workers; ++i)
+            if (pool[i].pid >= 0)
+            {
+                pfd[n] = (struct pollfd){.fd = pool[i].fd, .events = POLLIN};
+                idx[n++] = i;
+            }
+        if (poll(pfd, n, PROGRESS_MS) < 0 && errno != EINTR)
+        {
+            perror("poll");
+            break;
+        }
+        for (nfds_t j = 0; j < n; ++j)
+        {
+            if (!(pfd[j].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            Worker *wk = &pool[idx[j]];
+            if (!worker_read(wk))
+                continue;
+            close(wk->fd);
+            int status = 0;
+            (void)waitpid(wk->pid, &status, 0);
+            wk->pid = -1;
+            running--;
+            wk->out[wk->len] = '\0';
+            /* lo que termina después de Ctrl-C es una partida cortada: no cuenta */
+            if (interrupted)
+                continue;
+            MatchResult *r = &results[wk->match];
+            int ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            char last[160];
+            last_line(wk->out, wk->len, last, sizeof(last));
+            if (!ok || parse_ranking(wk->out, k, r) != 0)
+            {
+                r->status = -1;
+                failed++;
+                fprintf(stderr, "%stournament: partida %zu (semilla %u) falló (estado %d): %s\n",
+                        isatty(STDERR_FILENO) ? "\n" : "", wk->match, matches[wk->match].seed, status, last);
+            }
+            else
+                r->status = 1;
+            done++;
+        }
+        /* el CSV y los totales avanzan sólo por el prefijo completo: mismo resultado con cualquier -j */
+        while (flushed < total && results[flushed].status != 0)
+        {
+            if (csv)
+                write_csv_rows(csv, flushed, &matches[flushed], &results[flushed], k, names);
+            add_totals(totals, &matches[flushed], &results[flushed], k);
+            flushed++;
+        }
+        /* en una terminal se reescribe la línea; si no, una línea cada 10% */
+        uint64_t now = clock_ms();
+        size_t decile = done * 10 / total;
+        if (isatty(STDERR_FILENO) ? now - last_progress >= PROGRESS_MS : decile != last_decile)
+        {
+            print_progress(done, total, failed, running, t0, 0);
+            last_progress = now;
+            last_decile = decile;
+        }
+    }
+    if (isatty(STDERR_FILENO) || last_decile != 10)
+        print_progress(done, total, failed, running, t0, 1);
+    if (csv)
+        fclose(csv);
+
+    printf("\n=== TORNEO (%zu de %zu partidas%s) ===\n", flushed, total, interrupted ? ", interrumpido" : "");
+    /* "inválidos" ocupa un byte más que columnas */
+    printf("%-24s %8s %10s %12s %10s %11s %10s\n", "bot", "partidas", "victorias", "score medio", "puesto",
+           "inválidos", "timeouts");
+    for (unsigned b = 0; b < roster; ++b)
+    {
+        const BotTotals *t = &totals[b];
+        double m = t->matches ? (double)t->matches : 1.0;
+        printf("%-24s %8u %10.1f %12.1f %10.2f %10llu %10llu\n", names[b], t->matches, t->wins,
+               (double)t->score / m, (double)t->rank_sum / m, t->invalids, t->timeouts);
+    }
+    unsigned kept = prune_logs(workdir);
+    if (failed > 0 && kept > 0)
+        printf("stderr de los jugadores en %s/logs (%u archivos)\n", workdir, kept);
+
+    for (unsigned i = 0; i < workers; ++i)
+        free(pool[i].out);
+    for (unsigned b = 0; b < roster; ++b)
+        free(bots[b]);
+    free(idx);
+    free(pfd);
+    free(pool);
+    free(results);
+    free(matches);
+    free(seeds);
+    return interrupted || failed ? 1 : 0;
+}
@@ -19,6 +19,7 @@
 #include "state.h"
 #include "state_access.h"
 #include "sync.h"
+#include "frames.h"
 
 // Colores para los jugadores
 #define COLOR_PLAYER_BASE 10
@@ -29,6 +30,7 @@
 #define COLOR_UI 30
 #define CELL_HEIGHT 3
 #define CELL_WIDTH 5
+#define VIEW_RESYNC_MS 1000 // cada cuánto se reenvía la pantalla entera (el master también escribe en la terminal)
 
 // Globals para cleanup
 static GameState *global_state = NULL;
@@ -36,6 +38,52 @@ static int ncurses_initialized = 0;
 static SCREEN *global_scr = NULL;
 static volatile sig_atomic_t g_should_exit = 0;
 static int g_has_colors = 0;
+static FrameReader *global_frames = NULL;
+
+/* Lo último que se dibujó: plano de ocupación y cabezas. Una jugada sólo
+ * cambia bits del plano (capturas) y cabezas, así que el diff sale de ahí. */
+typedef struct {
+    uint64_t *occ;
+    unsigned hx[MAX_PLAYERS], hy[MAX_PLAYERS];
+} DrawnBoard;
+
+static DrawnBoard g_drawn = {0};
+
+/* Ventana sobre el tablero: celdas con borde (block 0) o un carácter por bloque de block×block celdas */
+typedef struct {
+    unsigned block;        /* 0 = celdas de CELL_WIDTH x CELL_HEIGHT; n = n×n celdas por carácter */
+    unsigned ox, oy;       /* celda de arriba a la izquierda */
+    unsigned span_x, span_y; /* celdas visibles (calculado en viewport_layout) */
+    bool fit;              /* elegir block y origen para ver el tablero entero */
+    bool changed;          /* cambió block u origen: hay que repintar todo */
+    int rows, cols;        /* área de la terminal disponible para el tablero */
+} Viewport;
+
+static Viewport g_vp = {.fit = true};
+
+/* Agregado del modo por bloques: una entrada por carácter de la ventana */
+typedef struct {
+    unsigned gw, gh;       /* caracteres de la grilla */
+    int8_t *owner;         /* dueño dominante o -1 */
+    uint8_t *density;      /* recompensa libre por celda del bloque, redondeada (0..9) */
+    uint32_t *count;       /* una fila de bloques: [libres, jugador 0..MAX_PLAYERS-1] por bloque */
+    uint64_t *rsum;        /* una fila de bloques: suma de recompensas libres por bloque */
+    bool *dirty;           /* filas de bloques a recalcular */
+} LodGrid;
+
+static LodGrid g_lod = {0};
+
+#define LOD_BINS (MAX_PLAYERS + 1)
+
+static void lod_free(void)
+{
+    free(g_lod.owner);
+    free(g_lod.density);
+    free(g_lod.count);
+    free(g_lod.rsum);
+    free(g_lod.dirty);
+    memset(&g_lod, 0, sizeof(g_lod));
+}
 
 static void request_exit(int sig)
 {
@@ -68,6 +116,11 @@ static void cleanup_and_exit(int code)
         }
         ncurses_initialized = 0;
     }
+    free(g_drawn.occ);
+    g_drawn.occ = NULL;
+    lod_free();
+    frames_detach(global_frames);
+    global_frames = NULL;
     if (global_state)
     {
         state_destroy(global_state);
@@ -79,6 +132,25 @@ static void cleanup_and_exit(int code)
 
 /* sin sleep: el master controla el ritmo */
 
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000L;
+}
+
+/* modo frames: la view marca su propio ritmo */
+static void sleep_until_ms(long long t)
+{
+    long long d = t - now_ms();
+    if (d <= 0)
+        return;
+    struct timespec ts;
+    ts.tv_sec = (time_t)(d / 1000);
+    ts.tv_nsec = (long)(d % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
 static void init_colors(void)
 {
     g_has_colors = has_colors();
@@ -172,112 +244,484 @@ static bool is_current_player_position(GameState *G, unsigned x, unsigned y)
     return false;
 }
 
-static void draw_board(GameState *G, int start_y, int start_x)
+/* contenido de una celda (relleno + carácter); los bordes los dibuja draw_cell_frame */
+static void draw_cell(GameState *G, unsigned x, unsigned y, int start_y, int start_x)
 {
-    unsigned w = G->w, h = G->h;
+    int cell_start_y = start_y + (int)((y - g_vp.oy) * (CELL_HEIGHT - 1));
+    int cell_start_x = start_x + (int)((x - g_vp.ox) * (CELL_WIDTH - 1));
 
-    safe_attron(COLOR_UI + 1, true, false);
-    mvprintw(start_y - 2, start_x, "Board (%ux%u)", w, h);
-    safe_attroff(COLOR_UI + 1, true, false);
+    int v = cell_get(G, idx(G, x, y));
+    int owner = cell_owner(v);
 
-    for (unsigned y = 0; y < h; y++)
+    int color_pair_id = COLOR_REWARD + 0;
+    char content_char;
+    bool is_owned = false;
+    bool is_current_pos = is_current_player_position(G, x, y);
+
+    if (owner >= 0)
     {
-        for (unsigned x = 0; x < w; x++)
+        is_owned = true;
+        if (is_current_pos) {
+            if (owner >= 5)
+                color_pair_id = COLOR_PLAYER_HEAD_HI + (owner % 8);
+            else
+                color_pair_id = COLOR_PLAYER_CURRENT + (owner % 8);
+        } else {
+            color_pair_id = COLOR_PLAYER_BASE + (owner % 8);
+        }
+        content_char = (char)('A' + owner);
+    }
+    else
+    {
+        int r = cell_reward(v);
+        if (r > 9)
+            r = 9; // Limitar a un dígito decimal
+
+        content_char = (char)('0' + r);
+    }
+
+    // Relleno interno (no colorear si es cabeza: sin fondo)
+    if (!(is_owned && is_current_pos)) {
+        safe_attron(color_pair_id, false, false);
+        for (int inner_y = 1; inner_y < CELL_HEIGHT - 1; ++inner_y)
+        {
+            for (int inner_x = 1; inner_x < CELL_WIDTH - 1; ++inner_x)
+            {
+                mvaddch(cell_start_y + inner_y, cell_start_x + inner_x, ' ');
+            }
+        }
+        safe_attroff(color_pair_id, false, false);
+    } else {
+        // limpiar con fondo por defecto
+        for (int inner_y = 1; inner_y < CELL_HEIGHT - 1; ++inner_y)
         {
-            int cell_start_y = start_y + (int)(y * (CELL_HEIGHT - 1));
-            int cell_start_x = start_x + (int)(x * (CELL_WIDTH - 1));
+            for (int inner_x = 1; inner_x < CELL_WIDTH - 1; ++inner_x)
+            {
+                mvaddch(cell_start_y + inner_y, cell_start_x + inner_x, ' ');
+            }
+        }
+    }
+
+    // Contenido centrado
+    if (is_owned && is_current_pos) {
+        int head_pair = COLOR_PLAYER_HEAD_FG + (owner % 8);
+        safe_attron(head_pair, true, false);
+        mvaddch(cell_start_y + (CELL_HEIGHT / 2),
+                cell_start_x + (CELL_WIDTH / 2), content_char);
+        safe_attroff(head_pair, true, false);
+    } else {
+        safe_attron(color_pair_id, is_owned, false);
+        mvaddch(cell_start_y + (CELL_HEIGHT / 2),
+                cell_start_x + (CELL_WIDTH / 2), content_char);
+        safe_attroff(color_pair_id, is_owned, false);
+    }
+}
 
-            int v = G->board[idx(G, x, y)];
-            int owner = cell_owner(v);
+/* bordes de una celda: no cambian entre frames */
+static void draw_cell_frame(unsigned x, unsigned y, unsigned w, unsigned h, int start_y, int start_x)
+{
+    int cell_start_y = start_y + (int)((y - g_vp.oy) * (CELL_HEIGHT - 1));
+    int cell_start_x = start_x + (int)((x - g_vp.ox) * (CELL_WIDTH - 1));
 
-            int color_pair_id = COLOR_REWARD + 0;
-            char content_char;
-            bool is_owned = false;
-            bool is_current_pos = is_current_player_position(G, x, y);
+    safe_attron(COLOR_UI + 0, false, false);
+    mvaddch(cell_start_y, cell_start_x, ACS_ULCORNER);
+    mvaddch(cell_start_y, cell_start_x + CELL_WIDTH - 1, (x == w - 1) ? ACS_URCORNER : ACS_TTEE);
+    mvaddch(cell_start_y + CELL_HEIGHT - 1, cell_start_x, (y == h - 1) ? ACS_LLCORNER : ACS_LTEE);
+    mvaddch(cell_start_y + CELL_HEIGHT - 1, cell_start_x + CELL_WIDTH - 1,
+            (x == w - 1 && y == h - 1) ? ACS_LRCORNER : ACS_PLUS);
 
-            if (owner >= 0)
+    for (int i = 1; i < CELL_WIDTH - 1; ++i)
+    {
+        mvaddch(cell_start_y, cell_start_x + i, ACS_HLINE);
+        mvaddch(cell_start_y + CELL_HEIGHT - 1, cell_start_x + i, ACS_HLINE);
+    }
+    for (int i = 1; i < CELL_HEIGHT - 1; ++i)
+    {
+        mvaddch(cell_start_y + i, cell_start_x, ACS_VLINE);
+        mvaddch(cell_start_y + i, cell_start_x + CELL_WIDTH - 1, ACS_VLINE);
+    }
+    safe_attroff(COLOR_UI + 0, false, false);
+}
+
+static void viewport_layout(const GameState *G, int rows, int cols)
+{
+    unsigned fit_cols = cols > 1 ? (unsigned)(cols - 1) / (CELL_WIDTH - 1) : 0;
+    unsigned fit_rows = rows > 1 ? (unsigned)(rows - 1) / (CELL_HEIGHT - 1) : 0;
+    if (cols < 1)
+        cols = 1;
+    if (rows < 1)
+        rows = 1;
+    if (cols != g_vp.cols || rows != g_vp.rows)
+        g_vp.changed = true;
+    g_vp.rows = rows;
+    g_vp.cols = cols;
+
+    if (g_vp.fit)
+    {
+        /* celdas con borde si entran; si no, el bloque más chico que muestra todo */
+        unsigned b = 0;
+        if (G->w > fit_cols || G->h > fit_rows)
+        {
+            unsigned bx = (G->w + (unsigned)cols - 1) / (unsigned)cols;
+            unsigned by = (G->h + (unsigned)rows - 1) / (unsigned)rows;
+            b = bx > by ? bx : by;
+        }
+        if (b != g_vp.block || g_vp.ox || g_vp.oy)
+            g_vp.changed = true;
+        g_vp.block = b;
+        g_vp.ox = g_vp.oy = 0;
+    }
+
+    if (g_vp.block == 0)
+    {
+        g_vp.span_x = fit_cols ? fit_cols : 1;
+        g_vp.span_y = fit_rows ? fit_rows : 1;
+    }
+    else
+    {
+        g_vp.span_x = (unsigned)cols * g_vp.block;
+        g_vp.span_y = (unsigned)rows * g_vp.block;
+    }
+    unsigned max_ox = G->w > g_vp.span_x ? G->w - g_vp.span_x : 0;
+    unsigned max_oy = G->h > g_vp.span_y ? G->h - g_vp.span_y : 0;
+    if (g_vp.ox > max_ox)
+        g_vp.ox = max_ox;
+    if (g_vp.oy > max_oy)
+        g_vp.oy = max_oy;
+}
+
+static bool cell_visible(unsigned x, unsigned y)
+{
+    return x >= g_vp.ox && x - g_vp.ox < g_vp.span_x && y >= g_vp.oy && y - g_vp.oy < g_vp.span_y;
+}
+
+/* zoom y desplazamiento; devuelve false si la tecla no es de la ventana */
+static bool viewport_key(const GameState *G, int ch)
+{
+    unsigned cx = g_vp.ox + g_vp.span_x / 2, cy = g_vp.oy + g_vp.span_y / 2;
+    unsigned step_x = g_vp.span_x / 4 ? g_vp.span_x / 4 : 1;
+    unsigned step_y = g_vp.span_y / 4 ? g_vp.span_y / 4 : 1;
+    unsigned max_block = G->w > G->h ? G->w : G->h;
+    switch (ch)
+    {
+    case KEY_LEFT: case 'h':
+        g_vp.ox = g_vp.ox > step_x ? g_vp.ox - step_x : 0;
+        break;
+    case KEY_RIGHT: case 'l':
+        g_vp.ox += step_x;
+        break;
+    case KEY_UP: case 'k':
+        g_vp.oy = g_vp.oy > step_y ? g_vp.oy - step_y : 0;
+        break;
+    case KEY_DOWN: case 'j':
+        g_vp.oy += step_y;
+        break;
+    case '+': case '=':
+        if (g_vp.block == 0)
+            return true;
+        g_vp.block /= 2;
+        break;
+    case '-':
+        if (g_vp.block >= max_block)
+            return true;
+        g_vp.block = g_vp.block ? g_vp.block * 2 : 1;
+        break;
+    case 'o': case 'O':
+        g_vp.fit = true;
+        g_vp.changed = true;
+        return true;
+    default:
+        return false;
+    }
+    if (ch == '+' || ch == '=' || ch == '-')
+    {
+        /* mantener el centro: el span nuevo sale de viewport_layout */
+        unsigned sx = g_vp.block ? (unsigned)g_vp.cols * g_vp.block
+                                 : (g_vp.cols > 1 ? (unsigned)(g_vp.cols - 1) / (CELL_WIDTH - 1) : 1);
+        unsigned sy = g_vp.block ? (unsigned)g_vp.rows * g_vp.block
+                                 : (g_vp.rows > 1 ? (unsigned)(g_vp.rows - 1) / (CELL_HEIGHT - 1) : 1);
+        g_vp.ox = cx > sx / 2 ? cx - sx / 2 : 0;
+        g_vp.oy = cy > sy / 2 ? cy - sy / 2 : 0;
+    }
+    g_vp.fit = false;
+    g_vp.changed = true;
+    return true;
+}
+
+static int lod_resize(unsigned gw, unsigned gh)
+{
+    if (g_lod.owner && g_lod.gw == gw && g_lod.gh == gh)
+        return 0;
+    lod_free();
+    size_t n = (size_t)gw * gh;
+    g_lod.owner = malloc(n);
+    g_lod.density = malloc(n);
+    g_lod.count = malloc((size_t)gw * LOD_BINS * sizeof(uint32_t));
+    g_lod.rsum = malloc((size_t)gw * sizeof(uint64_t));
+    g_lod.dirty = malloc(gh * sizeof(bool));
+    g_lod.gw = gw;
+    g_lod.gh = gh;
+    if (!g_lod.owner || !g_lod.density || !g_lod.count || !g_lod.rsum || !g_lod.dirty)
+    {
+        lod_free();
+        return -1;
+    }
+    return 0;
+}
+
+/* Una fila de bloques en una pasada por filas del tablero (acceso secuencial):
+ * cuenta celdas libres y por dueño y suma recompensas, después elige el dominante. */
+static void lod_compute_row(const GameState *G, unsigned j)
+{
+    const unsigned b = g_vp.block, gw = g_lod.gw;
+    memset(g_lod.count, 0, (size_t)gw * LOD_BINS * sizeof(uint32_t));
+    memset(g_lod.rsum, 0, (size_t)gw * sizeof(uint64_t));
+
+    unsigned y0 = g_vp.oy + j * b;
+    unsigned y1 = y0 + b < G->h ? y0 + b : G->h;
+    unsigned x1 = g_vp.ox + gw * b < G->w ? g_vp.ox + gw * b : G->w;
+    for (unsigned y = y0; y < y1; ++y)
+    {
+        size_t base = idx(G, 0, y);
+        uint32_t *cnt = g_lod.count;
+        uint64_t *rs = g_lod.rsum;
+        unsigned k = 0;
+        for (unsigned x = g_vp.ox; x < x1; ++x)
+        {
+            int v = cell_get(G, base + x);
+            if (v < 0)
+                cnt[-v]++;              /* dueño o -> bin o+1 */
+            else
             {
-                is_owned = true;
-                if (is_current_pos) {
-                    if (owner >= 5)
-                        color_pair_id = COLOR_PLAYER_HEAD_HI + (owner % 8);
-                    else
-                        color_pair_id = COLOR_PLAYER_CURRENT + (owner % 8);
-                } else {
-                    color_pair_id = COLOR_PLAYER_BASE + (owner % 8);
-                }
-                content_char = (char)('A' + owner);
+                cnt[0]++;
+                *rs += (uint64_t)v;
             }
-            else
+            if (++k == b)
             {
-                int r = cell_reward(v);
-                if (r > 9)
-                    r = 9; // Limitar a un dígito decimal
-
-                content_char = (char)('0' + r);
+                k = 0;
+                cnt += LOD_BINS;
+                rs++;
             }
+        }
+    }
 
-            // Relleno interno (no colorear si es cabeza: sin fondo)
-            if (!(is_owned && is_current_pos)) {
-                safe_attron(color_pair_id, false, false);
-                for (int inner_y = 1; inner_y < CELL_HEIGHT; ++inner_y)
-                {
-                    for (int inner_x = 1; inner_x < CELL_WIDTH; ++inner_x)
-                    {
-                        mvaddch(cell_start_y + inner_y, cell_start_x + inner_x, ' ');
-                    }
-                }
-                safe_attroff(color_pair_id, false, false);
-            } else {
-                // limpiar con fondo por defecto
-                for (int inner_y = 1; inner_y < CELL_HEIGHT; ++inner_y)
-                {
-                    for (int inner_x = 1; inner_x < CELL_WIDTH; ++inner_x)
-                    {
-                        mvaddch(cell_start_y + inner_y, cell_start_x + inner_x, ' ');
-                    }
-                }
+    for (unsigned i = 0; i < gw; ++i)
+    {
+        const uint32_t *cnt = g_lod.count + (size_t)i * LOD_BINS;
+        int best = -1;
+        uint32_t best_n = 0, total = cnt[0];
+        for (unsigned o = 0; o < G->n_players; ++o)
+        {
+            total += cnt[o + 1];
+            if (cnt[o + 1] > best_n)
+            {
+                best_n = cnt[o + 1];
+                best = (int)o;
             }
+        }
+        size_t at = (size_t)j * gw + i;
+        /* dominante si tiene al menos tantas celdas como las libres */
+        g_lod.owner[at] = (int8_t)(best >= 0 && best_n >= cnt[0] ? best : -1);
+        /* recompensa que queda por celda del bloque: baja a medida que se come */
+        g_lod.density[at] = total ? (uint8_t)((g_lod.rsum[i] + total / 2) / total) : 0;
+    }
+}
 
-            // Contenido centrado
-            if (is_owned && is_current_pos) {
-                int head_pair = COLOR_PLAYER_HEAD_FG + (owner % 8);
-                safe_attron(head_pair, true, false);
-                mvaddch(cell_start_y + (CELL_HEIGHT / 2),
-                        cell_start_x + (CELL_WIDTH / 2), content_char);
-                safe_attroff(head_pair, true, false);
-            } else {
-                safe_attron(color_pair_id, is_owned, false);
-                mvaddch(cell_start_y + (CELL_HEIGHT / 2),
-                        cell_start_x + (CELL_WIDTH / 2), content_char);
-                safe_attroff(color_pair_id, is_owned, false);
-            }
+/* carácter del bloque (i, j): dueño dominante, densidad de recompensa o cabeza */
+static void lod_draw_char(const GameState *G, unsigned i, unsigned j, int start_y, int start_x)
+{
+    const unsigned b = g_vp.block;
+    unsigned bx0 = g_vp.ox + i * b, by0 = g_vp.oy + j * b;
+    int sy = start_y + (int)j, sx = start_x + (int)i;
+    if (bx0 >= G->w || by0 >= G->h)
+    {
+        mvaddch(sy, sx, ' ');
+        return;
+    }
+    for (unsigned p = 0; p < G->n_players; ++p)
+        if (G->P[p].x - bx0 < b && G->P[p].y - by0 < b)
+        {
+            int head_pair = COLOR_PLAYER_HEAD_FG + (int)(p % 8);
+            safe_attron(head_pair, true, false);
+            mvaddch(sy, sx, (chtype)('A' + p));
+            safe_attroff(head_pair, true, false);
+            return;
+        }
+    size_t at = (size_t)j * g_lod.gw + i;
+    int owner = g_lod.owner[at];
+    if (owner >= 0)
+    {
+        int pair = COLOR_PLAYER_BASE + (owner % 8);
+        safe_attron(pair, true, false);
+        mvaddch(sy, sx, (chtype)('A' + owner));
+        safe_attroff(pair, true, false);
+    }
+    else
+    {
+        safe_attron(COLOR_REWARD + 0, false, false);
+        mvaddch(sy, sx, (chtype)('0' + g_lod.density[at]));
+        safe_attroff(COLOR_REWARD + 0, false, false);
+    }
+}
 
-            // Bordes
-            safe_attron(COLOR_UI + 0, false, false);
-            mvaddch(cell_start_y, cell_start_x, ACS_ULCORNER);
-            mvaddch(cell_start_y, cell_start_x + CELL_WIDTH - 1, (x == w - 1) ? ACS_URCORNER : ACS_TTEE);
-            mvaddch(cell_start_y + CELL_HEIGHT - 1, cell_start_x, (y == h - 1) ? ACS_LLCORNER : ACS_LTEE);
-            mvaddch(cell_start_y + CELL_HEIGHT - 1, cell_start_x + CELL_WIDTH - 1,
-                    (x == w - 1 && y == h - 1) ? ACS_LRCORNER : ACS_PLUS);
+static void lod_draw_row(const GameState *G, unsigned j, int start_y, int start_x)
+{
+    for (unsigned i = 0; i < g_lod.gw; ++i)
+        lod_draw_char(G, i, j, start_y, start_x);
+}
 
-            for (int i = 1; i < CELL_WIDTH - 1; ++i)
-            {
-                mvaddch(cell_start_y, cell_start_x + i, ACS_HLINE);
-                mvaddch(cell_start_y + CELL_HEIGHT - 1, cell_start_x + i, ACS_HLINE);
-            }
-            for (int i = 1; i < CELL_HEIGHT - 1; ++i)
+/* redibuja lo que ocupa la celda (x, y) en la ventana actual */
+static void redraw_cell(GameState *G, unsigned x, unsigned y, int start_y, int start_x)
+{
+    if (x >= G->w || y >= G->h || !cell_visible(x, y))
+        return;
+    if (g_vp.block == 0)
+        draw_cell(G, x, y, start_y, start_x);
+    else
+        lod_draw_char(G, (x - g_vp.ox) / g_vp.block, (y - g_vp.oy) / g_vp.block, start_y, start_x);
+}
+
+static void redraw_head_cells(GameState *G, int start_y, int start_x)
+{
+    for (unsigned i = 0; i < G->n_players; ++i)
+    {
+        unsigned x = G->P[i].x, y = G->P[i].y;
+        if (x == g_drawn.hx[i] && y == g_drawn.hy[i])
+            continue;
+        /* la cabeza anterior deja de serlo (si estaba en el tablero) */
+        redraw_cell(G, g_drawn.hx[i], g_drawn.hy[i], start_y, start_x);
+        redraw_cell(G, x, y, start_y, start_x);
+        g_drawn.hx[i] = x;
+        g_drawn.hy[i] = y;
+    }
+}
+
+static void draw_board_title(const GameState *G, int y, int x)
+{
+    static int title_len;
+    char title[128];
+    if (g_vp.block == 0 && g_vp.span_x >= G->w && g_vp.span_y >= G->h)
+        snprintf(title, sizeof(title), "Board (%ux%u)", G->w, G->h);
+    else
+    {
+        unsigned x1 = g_vp.ox + g_vp.span_x < G->w ? g_vp.ox + g_vp.span_x : G->w;
+        unsigned y1 = g_vp.oy + g_vp.span_y < G->h ? g_vp.oy + g_vp.span_y : G->h;
+        snprintf(title, sizeof(title), "Board (%ux%u)  1:%u  x %u-%u  y %u-%u", G->w, G->h,
+                 g_vp.block ? g_vp.block : 1, g_vp.ox, x1 - 1, g_vp.oy, y1 - 1);
+    }
+    safe_attron(COLOR_UI + 1, true, false);
+    mvaddstr(y, x, title);
+    for (int i = (int)strlen(title); i < title_len; ++i)
+        addch(' ');
+    title_len = (int)strlen(title);
+    safe_attroff(COLOR_UI + 1, true, false);
+}
+
+static void draw_board(GameState *G, int start_y, int start_x, bool full)
+{
+    unsigned w = G->w, h = G->h;
+    size_t words = occ_words_per_row(w);
+
+    if (!g_drawn.occ)
+    {
+        g_drawn.occ = calloc(words * h, sizeof(uint64_t));
+        full = true;
+    }
+    if (g_vp.changed)
+        full = true;
+    g_vp.changed = false;
+    const unsigned b = g_vp.block;
+
+    if (full)
+    {
+        draw_board_title(G, start_y - 2, start_x);
+        if (g_drawn.occ)
+            memcpy(g_drawn.occ, occ_row(G, 0), words * h * sizeof(uint64_t));
+        for (unsigned i = 0; i < G->n_players; ++i)
+        {
+            g_drawn.hx[i] = G->P[i].x;
+            g_drawn.hy[i] = G->P[i].y;
+        }
+        if (b == 0)
+        {
+            /* sólo las celdas de la ventana: el resto no se ve */
+            for (unsigned y = g_vp.oy; y < h && y - g_vp.oy < g_vp.span_y; y++)
+                for (unsigned x = g_vp.ox; x < w && x - g_vp.ox < g_vp.span_x; x++)
+                {
+                    draw_cell_frame(x, y, w, h, start_y, start_x);
+                    draw_cell(G, x, y, start_y, start_x);
+                }
+            return;
+        }
+        if (lod_resize((unsigned)g_vp.cols, (unsigned)g_vp.rows) != 0)
+            return;
+        for (unsigned j = 0; j < g_lod.gh; ++j)
+        {
+            lod_compute_row(G, j);
+            lod_draw_row(G, j, start_y, start_x);
+        }
+        return;
+    }
+    if (!g_drawn.occ)
+        return;
+
+    /* sólo lo capturado desde el último frame: en celdas se redibuja cada una,
+       por bloques se recalculan las filas de bloques que la contienen */
+    if (b > 0)
+        memset(g_lod.dirty, 0, g_lod.gh * sizeof(bool));
+    for (unsigned y = 0; y < h; y++)
+    {
+        const uint64_t *row = occ_row(G, y);
+        uint64_t *seen = g_drawn.occ + (size_t)y * words;
+        for (size_t k = 0; k < words; ++k)
+        {
+            uint64_t diff = row[k] ^ seen[k];
+            if (!diff)
+                continue;
+            seen[k] = row[k];
+            for (; diff; diff &= diff - 1)
             {
-                mvaddch(cell_start_y + i, cell_start_x, ACS_VLINE);
-                mvaddch(cell_start_y + i, cell_start_x + CELL_WIDTH - 1, ACS_VLINE);
+                unsigned x = (unsigned)(k * OCC_WORD_BITS) + (unsigned)__builtin_ctzll(diff);
+                if (!cell_visible(x, y))
+                    continue;
+                if (b == 0)
+                    draw_cell(G, x, y, start_y, start_x);
+                else
+                    g_lod.dirty[(y - g_vp.oy) / b] = true;
             }
-            safe_attroff(COLOR_UI + 0, false, false);
         }
     }
+    if (b > 0)
+        for (unsigned j = 0; j < g_lod.gh; ++j)
+            if (g_lod.dirty[j])
+            {
+                lod_compute_row(G, j);
+                lod_draw_row(G, j, start_y, start_x);
+            }
+    redraw_head_cells(G, start_y, start_x);
+}
+
+/* texto que puede acortarse entre frames: tapa con espacios lo que sobra del anterior */
+static void print_field(int y, int x, int pair, const char *text, int *prev_len)
+{
+    /* cortado en el borde: si envuelve pisa la línea de abajo (título del tablero) */
+    int room = getmaxx(stdscr) - x;
+    if (room <= 0)
+        return;
+    int len = (int)strlen(text);
+    if (len > room)
+        len = room;
+    safe_attron(pair, false, false);
+    mvaddnstr(y, x, text, len);
+    safe_attroff(pair, false, false);
+    for (int i = len; i < *prev_len && i < room; ++i)
+        addch(' ');
+    *prev_len = len;
 }
 
 static void draw_players_info(GameState *G, int start_y, int start_x)
 {
+    static int info_len[MAX_PLAYERS];
     unsigned n = G->n_players;
 
     safe_attron(COLOR_UI + 1, true, false);
@@ -295,10 +739,9 @@ static void draw_players_info(GameState *G, int start_y, int start_x)
         safe_attroff(color_pair, true, false);
 
         // Info básica
-        safe_attron(COLOR_UI + 0, false, false);
-        mvprintw(y, start_x + 4, "pos=(%u,%u) score=%u",
-                 G->P[i].x, G->P[i].y, G->P[i].score);
-        safe_attroff(COLOR_UI + 0, false, false);
+        char info[64];
+        snprintf(info, sizeof(info), "pos=(%u,%u) score=%u", G->P[i].x, G->P[i].y, G->P[i].score);
+        print_field(y, start_x + 4, COLOR_UI + 0, info, &info_len[i]);
 
         // Stats
         safe_attron(COLOR_UI + 3, false, false);
@@ -337,10 +780,30 @@ static void draw_game_info(GameState *G, int start_y, int start_x)
         safe_attroff(COLOR_UI + 3, true, false);
     }
 
+    static int free_len;
     safe_attron(COLOR_UI + 0, false, false);
     mvprintw(start_y + 4, start_x, "Board: %ux%u", G->w, G->h);
     mvprintw(start_y + 5, start_x, "Players: %u", G->n_players);
     safe_attroff(COLOR_UI + 0, false, false);
+    char line[96];
+    snprintf(line, sizeof(line), "Free: %llu  Rewards: %llu (sum %llu)",
+             (unsigned long long)state_free_cells(G),
+             (unsigned long long)state_remaining_rewards(G),
+             (unsigned long long)state_remaining_reward_sum(G));
+    print_field(start_y + 6, start_x, COLOR_UI + 0, line, &free_len);
+}
+
+/* todas las teclas pendientes; devuelve 1 si se pidió salir */
+static int handle_keys(const GameState *G)
+{
+    int ch;
+    while ((ch = getch()) != ERR)
+    {
+        if (ch == 'q' || ch == 'Q')
+            return 1;
+        viewport_key(G, ch);
+    }
+    return 0;
 }
 
 static void draw_legend(int start_y, int start_x)
@@ -352,7 +815,9 @@ static void draw_legend(int start_y, int start_x)
     safe_attron(COLOR_UI + 0, false, false);
     mvprintw(start_y + 2, start_x, "A-H : Player territories");
     mvprintw(start_y + 3, start_x, "0-9 : Reward values");
-    mvprintw(start_y + 4, start_x, "Press 'q' to quit");
+    mvprintw(start_y + 4, start_x, "+/- : Zoom  (o: fit board)");
+    mvprintw(start_y + 5, start_x, "Arrows/hjkl : Pan");
+    mvprintw(start_y + 6, start_x, "Press 'q' to quit");
     safe_attroff(COLOR_UI + 0, false, false);
 }
 
@@ -401,12 +866,45 @@ int main(int argc, char *argv[])
 
     init_colors();
 
+    // Modo frames: snapshots del triple buffer al ritmo de la view, sin semáforos con el master
+    if (sync_view_frames_enabled())
+    {
+        global_frames = frames_attach();
+        if (!global_frames)
+        {
+            fprintf(stderr, "frames_attach failed: %s\n", strerror(errno));
+            cleanup_and_exit(1);
+        }
+    }
+    long long frame_ms = global_frames ? 1000 / (long long)frames_fps(global_frames) : 0;
+    long long next_tick = now_ms();
+
     // Loop principal de renderizado
     int frame = 0;
     int quit_requested = 0;
-    while (!g_should_exit && frame < 2000)
+    int last_y = -1, last_x = -1; // tamaño de terminal del último repintado completo
+    long long last_resync = now_ms();
+    while (!g_should_exit && (global_frames || frame < 2000))
     {
-    view_wait_update_ready();
+        if (global_frames)
+        {
+            // Sólo el frame más nuevo; si el master no publicó nada desde el último, no se dibuja
+            sleep_until_ms(next_tick);
+            next_tick = now_ms() + frame_ms;
+            GameState *F = frames_latest(global_frames, NULL);
+            if (handle_keys(G))
+                break;
+            // sin frame nuevo sólo se redibuja el último si se movió la ventana
+            if (!F && !g_vp.changed)
+                continue;
+            if (F)
+                G = F;
+        }
+        else
+        {
+            view_wait_update_ready();
+            quit_requested = handle_keys(G);
+        }
 
         /* Validación opcional de tamaños si vinieron por argv */
         if (argW && argH && (G->w != argW || G->h != argH))
@@ -421,16 +919,6 @@ int main(int argc, char *argv[])
             }
         }
 
-        // Input no bloqueante
-        int ch = getch();
-        if (ch == 'q' || ch == 'Q')
-        {
-            quit_requested = 1;
-        }
-
-        // Limpiar pantalla
-        clear();
-
         // Dimensiones terminal
         int max_y, max_x;
         getmaxyx(stdscr, max_y, max_x);
@@ -448,14 +936,24 @@ int main(int argc, char *argv[])
             board_height = 5;
         if (board_width < 20)
             board_width = 20;
+        viewport_layout(G, board_height, board_width);
+
+        // Repintado completo al inicio, si cambió la terminal o la ventana; si no, sólo lo que cambió
+        bool full = (max_y != last_y || max_x != last_x || g_vp.changed);
+        if (full)
+        {
+            erase();
+            last_y = max_y;
+            last_x = max_x;
+        }
 
         // Dibujos
-        draw_board(G, board_start_y, board_start_x);
+        draw_board(G, board_start_y, board_start_x, full);
 
         int panel_x = board_start_x + board_width + 2;
         // Texto arriba (status y leyenda)
         draw_game_info(G, 1, panel_x);
-        draw_legend(6, panel_x);
+        draw_legend(8, panel_x);
 
         // Info de jugadores también en el bloque superior
         int players_y = 1;
@@ -467,9 +965,17 @@ int main(int argc, char *argv[])
 
     int game_over_now = G->game_over ? 1 : 0;
 
-        // Actualizar pantalla
+        // Actualizar pantalla; cada tanto se reenvía entera desde el buffer de ncurses
+        // (sin redibujar celdas) para tapar lo que el master imprima en la misma terminal
+        long long t = now_ms();
+        if (t - last_resync >= VIEW_RESYNC_MS)
+        {
+            clearok(curscr, TRUE);
+            last_resync = t;
+        }
         refresh();
-        view_signal_render_complete();
+        if (!global_frames)
+            view_signal_render_complete();
 
         if (game_over_now || quit_requested)
             break;